@@ -5,7 +5,8 @@
  * - isDirty(key) - check if RAM differs from NVS
  * - isModified(key) - check if value differs from default
  * - save(key) - persist single key with default removal
- * - save() - persist all dirty keys in batch
+ * - save() - persist all dirty keys in batch, with a SaveReport
+ * - anyDirty() - cheap check for unsaved changes
  *
  * This example shows how changes are tracked in RAM
  * and only written to flash when you call save().
@@ -63,8 +64,12 @@ void setup() {
     printStatus("After reset to default");
 
     // 5. Save all remaining dirty values
-    Serial.println("\nSaving all dirty values with save()...");
-    QPrefs::save();
+    Serial.printf("\nanyDirty: %s\n", QPrefs::anyDirty() ? "YES" : "no");
+    Serial.println("Saving all dirty values with save()...");
+    auto report = QPrefs::save();
+    Serial.printf("Wrote %u keys (%u bytes) in %u namespaces, %lu us\n",
+        (unsigned)report.written, (unsigned)report.bytes_written,
+        (unsigned)report.namespaces_opened, (unsigned long)report.elapsed_us);
     printStatus("After save() - all clean");
 
     // 6. Demonstrate isModified vs isDirty
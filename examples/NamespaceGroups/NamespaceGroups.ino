@@ -3,6 +3,7 @@
  *
  * Demonstrates:
  * - Organizing preferences into namespaces
+ * - preloadAll() - load every key with one NVS open per namespace
  * - forEach() - iterate all registered preferences
  * - forEachInNamespace() - iterate keys in specific namespace
  * - factoryReset() - clear all NVS and restore defaults
@@ -33,14 +34,8 @@ void setup() {
     Serial.println("QPreferences Namespace Groups Example");
     Serial.println("======================================\n");
 
-    // Initialize all preferences (triggers lazy load from NVS)
-    QPrefs::get(wifiSSID);
-    QPrefs::get(wifiPassword);
-    QPrefs::get(autoConnect);
-    QPrefs::get(brightness);
-    QPrefs::get(nightMode);
-    QPrefs::get(threshold);
-    QPrefs::get(interval);
+    // Load all preferences up front (one NVS open per namespace)
+    QPrefs::preloadAll();
 
     // 1. List ALL registered preferences
     Serial.println("=== All Registered Preferences ===");
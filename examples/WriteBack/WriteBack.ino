@@ -0,0 +1,46 @@
+/**
+ * QPreferences Write-Back Example
+ *
+ * Demonstrates:
+ * - startWriteBack() - background task that flushes dirty keys automatically
+ * - debounce_ms - a burst of set() calls costs a single flash write
+ * - max_staleness_ms - continuous changes are still saved periodically
+ * - stopWriteBack() - stop the task and flush what is left
+ *
+ * The sketch bumps a counter every 100 ms. Without write-back nothing would
+ * reach flash until save() is called; with it, the counter is persisted at
+ * most every 10 seconds while changing, and 2 seconds after it stops.
+ */
+
+// The write-back task saves while loop() changes values: synchronize the cache
+#define QPREFERENCES_THREAD_SAFE
+#include <QPreferences/WriteBack.h>
+
+PrefKey<int, "wb", "ticks"> ticks{0};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("QPreferences Write-Back Example");
+    Serial.println("==============================");
+    Serial.printf("ticks restored from NVS: %d\n", QPrefs::get(ticks));
+
+    QPrefs::startWriteBack({
+        .debounce_ms = 2000,
+        .max_staleness_ms = 10000,
+    });
+}
+
+void loop() {
+    static unsigned long start = millis();
+
+    // Change the value for 30 seconds, then stay quiet
+    if (millis() - start < 30000) {
+        QPrefs::increment(ticks);
+    }
+
+    Serial.printf("ticks=%d, unsaved=%s\n", QPrefs::get(ticks),
+        QPrefs::anyDirty() ? "YES" : "no");
+    delay(100);
+}
@@ -1,60 +1,85 @@
 #ifndef QPREFERENCES_CACHEENTRY_H
 #define QPREFERENCES_CACHEENTRY_H
 
-#include <variant>
-#include <optional>
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <WString.h>
+#include <type_traits>
+#include <utility>
+#include "FixedString.h"
+#include "FixedVector.h"
+#include "StringLiteral.h"
+#include "PrefOptions.h"
+#include "Sync.h"
 
-namespace QPreferences {
+class Preferences;
 
-/**
- * @brief Type-safe variant for storing preference values in cache.
- *
- * Supports the core ESP32 Preferences types: int, int32_t, float, bool, String.
- * Both int and int32_t are included as distinct types (even if same size on ESP32).
- * Uses std::variant for fixed-size, RTTI-free storage (no heap allocation).
- */
-using ValueVariant = std::variant<int, int32_t, float, bool, String>;
+namespace QPreferences {
 
 /**
  * @brief Cache entry for a single preference with four-state tracking.
  *
- * Each cache entry stores:
- * - value: Current cached value (in RAM)
- * - nvs_value: Last-known NVS value (empty = no value stored in NVS)
+ * Each cache entry stores one byte of status bits:
  * - initialized: Whether we've attempted to load from NVS (controls lazy loading)
  * - dirty: Flag indicating if RAM value differs from NVS baseline
+ * - has_nvs_value: Whether NVS holds a value (the typed baseline is valid)
+ * - bool_value / bool_baseline: Value and NVS baseline of bool keys
+ * - stale_nvs: NVS holds a value that no longer fits the key's type
+ *
+ * Values of all other types live in per-key typed storage (ValueSlot<T>),
+ * so each key pays only for its own type and no variant discriminator.
  *
  * Key distinction:
  * - initialized tracks "have we tried to load this?" (lazy loading gate)
- * - nvs_value.has_value() tracks "does NVS actually have a stored value?"
+ * - has_nvs_value tracks "does NVS actually have a stored value?"
  *
  * This enables:
  * - Lazy initialization (load from NVS only on first access)
  * - Smart dirty tracking (compare against NVS value or default appropriately)
  * - Read-only NVS access (don't create namespaces unnecessarily)
+ *
+ * The bits share one byte that is read and updated with single atomic
+ * operations in thread-safe builds, so a flag can be tested from any task
+ * without a lock.
  */
 struct CacheEntry {
-    /// Current cached value (in RAM)
-    ValueVariant value;
+    static constexpr uint8_t INITIALIZED = 1 << 0;    ///< Load from NVS attempted
+    static constexpr uint8_t DIRTY = 1 << 1;          ///< RAM value differs from NVS baseline
+    static constexpr uint8_t HAS_NVS_VALUE = 1 << 2;  ///< A value is stored in NVS (baseline valid)
+    static constexpr uint8_t BOOL_VALUE = 1 << 3;     ///< Current cached value of a bool key
+    static constexpr uint8_t BOOL_BASELINE = 1 << 4;  ///< Last-known NVS value of a bool key
+    static constexpr uint8_t STALE_NVS = 1 << 5;      ///< NVS value unreadable (layout changed); dirty until saved
 
-    /// Last-known NVS value (empty = no value stored in NVS)
-    std::optional<ValueVariant> nvs_value;
+    /// Status bits (see constants above)
+    uint8_t flags = 0;
 
-    /// Whether this entry has been initialized (attempted load from NVS)
-    bool initialized = false;
+    /**
+     * @brief Test a status bit.
+     */
+    bool test(uint8_t mask) const {
+        return (atomic_read(flags) & mask) != 0;
+    }
 
-    /// Flag indicating if RAM value differs from NVS baseline
-    bool dirty = false;
+    /**
+     * @brief Set or clear a status bit.
+     * @return The previous state of the bit
+     */
+    bool assign(uint8_t mask, bool on) {
+        uint8_t previous = on ? atomic_fetch_or(flags, mask)
+                              : atomic_fetch_and(flags, static_cast<uint8_t>(~mask));
+        return (previous & mask) != 0;
+    }
 
     /**
      * @brief Check if this entry has been initialized from NVS.
      * @return true if initialization has been attempted, false otherwise
      */
     bool is_initialized() const {
-        return initialized;
+        return test(INITIALIZED);
     }
 
     /**
@@ -62,8 +87,259 @@ struct CacheEntry {
      * @return true if dirty flag is set, false otherwise
      */
     bool is_dirty() const {
-        return dirty;
+        return test(DIRTY);
+    }
+
+    /**
+     * @brief Check if NVS holds a value for this key.
+     */
+    bool has_nvs_value() const {
+        return test(HAS_NVS_VALUE);
+    }
+
+    /**
+     * @brief Check if NVS holds a value that couldn't be read back (e.g. a resized struct).
+     */
+    bool is_stale() const {
+        return test(STALE_NVS);
+    }
+
+    void set_initialized() { assign(INITIALIZED, true); }
+    void set_has_nvs_value(bool on) { assign(HAS_NVS_VALUE, on); }
+    void set_stale(bool on) { assign(STALE_NVS, on); }
+};
+
+/**
+ * @brief Typed RAM storage for one non-bool preference key.
+ *
+ * @tparam T The key's value type
+ */
+template<typename T>
+struct ValueSlot {
+    /// Current cached value (in RAM)
+    T value{};
+
+    /// Last-known NVS value (valid only when CacheEntry::has_nvs_value)
+    T baseline{};
+
+    /// Guards value and baseline in thread-safe builds (unused for lock-free scalars)
+    [[no_unique_address]] std::conditional_t<is_lock_free_value<T>, NoLock, Mutex> mutex;
+};
+
+/**
+ * @brief RAM storage for a String key with a hashed baseline (Baseline::Hash).
+ *
+ * Keeps length + hash of the NVS value instead of a second String copy.
+ */
+struct HashedStringSlot {
+    /// Current cached value (in RAM)
+    String value;
+
+    /// Length of the last-known NVS value
+    size_t baseline_length = 0;
+
+    /// fnv1a() of the last-known NVS value
+    uint32_t baseline_hash = 0;
+
+    /// Guards the value and baseline in thread-safe builds
+    [[no_unique_address]] Mutex mutex;
+};
+
+/**
+ * @brief Whether a key type stores a hashed baseline.
+ */
+template<typename KeyType>
+inline constexpr bool uses_hashed_baseline = KeyType::options.baseline == Baseline::Hash;
+
+/**
+ * @brief Whether values of type T are stored as one raw NVS blob (putBytes/getBytes).
+ *
+ * Trivially copyable structs, including std::array; scalars, String and
+ * FixedString map onto their own NVS types, and FixedVector stores only
+ * its used elements.
+ */
+template<typename T>
+inline constexpr bool is_blob_value =
+    std::is_trivially_copyable_v<T> && std::is_class_v<T> && !is_fixed_string<T> && !is_fixed_vector<T>;
+
+/**
+ * @brief Compare two values: operator== if T has one, memcmp for plain blob structs.
+ *
+ * memcmp also compares padding bytes, so give blob structs without
+ * operator== a padding-free layout (or define operator==).
+ */
+template<typename T>
+bool values_equal(const T& a, const T& b) {
+    if constexpr (is_blob_value<T> && !std::equality_comparable<T>) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    } else {
+        return a == b;
+    }
+}
+
+/**
+ * @brief Whether a key type compares values with a dead-band.
+ */
+template<typename KeyType>
+inline constexpr bool uses_deadband = KeyType::options.abs_epsilon != 0.0f || KeyType::options.rel_epsilon != 0.0f;
+
+/**
+ * @brief Whether a change from a to b is significant enough to make a key dirty.
+ *
+ * Exact comparison unless the key's PrefOptions set a dead-band, in which
+ * case a difference within abs_epsilon, or within rel_epsilon of the larger
+ * magnitude, is ignored. NaN always counts as a change.
+ *
+ * @tparam KeyType The PrefKey type
+ */
+template<typename KeyType, typename T>
+bool differs(const T& a, const T& b) {
+    if constexpr (uses_deadband<KeyType>) {
+        double diff = std::fabs(static_cast<double>(a) - static_cast<double>(b));
+        double magnitude = std::fmax(std::fabs(static_cast<double>(a)), std::fabs(static_cast<double>(b)));
+        return !(diff <= KeyType::options.abs_epsilon || diff <= KeyType::options.rel_epsilon * magnitude);
+    } else {
+        return !values_equal(a, b);
+    }
+}
+
+/**
+ * @brief Storage type of a key: ValueSlot<T>, or HashedStringSlot for Baseline::Hash.
+ */
+template<typename KeyType>
+using slot_type = std::conditional_t<uses_hashed_baseline<KeyType>,
+                                     HashedStringSlot,
+                                     ValueSlot<typename KeyType::value_type>>;
+
+/**
+ * @brief Typed storage for a key type, sized for exactly that type.
+ *
+ * One instance per PrefKey type that is actually used; bool keys don't
+ * instantiate it (their bits live in CacheEntry).
+ */
+template<typename KeyType>
+inline slot_type<KeyType> value_slot;
+
+/**
+ * @brief Typed access to a key's cached value and NVS baseline.
+ *
+ * Hides whether the value lives in value_slot<KeyType> or in the bool bits
+ * of the CacheEntry, and how the baseline is kept, so accessors index
+ * typed storage directly.
+ *
+ * Synchronization (thread-safe builds): writers hold lock(entry) while
+ * changing the value and recomputing the dirty flag. Lock-free values
+ * (word-sized scalars and bools) are stored atomically and read without a
+ * lock; other values are read under read_lock(entry), the same per-key Mutex.
+ *
+ * @tparam KeyType The PrefKey type
+ */
+template<typename KeyType,
+         typename T = typename KeyType::value_type,
+         bool Hashed = uses_hashed_baseline<KeyType>>
+struct SlotAccess {
+    static constexpr bool lock_free = is_lock_free_value<T>;
+
+    /// Current value: a copy for lock-free scalars, otherwise a reference (hold read_lock)
+    static decltype(auto) value(const CacheEntry&) {
+        if constexpr (lock_free) {
+            return atomic_read(value_slot<KeyType>.value);
+        } else {
+            return static_cast<const T&>(value_slot<KeyType>.value);
+        }
+    }
+
+    static void set_value(CacheEntry&, const T& v) {
+        if constexpr (lock_free) {
+            atomic_write(value_slot<KeyType>.value, v);
+        } else {
+            value_slot<KeyType>.value = v;
+        }
+    }
+
+    static void set_value(CacheEntry& entry, T&& v) {
+        if constexpr (lock_free) {
+            set_value(entry, static_cast<const T&>(v));
+        } else {
+            value_slot<KeyType>.value = std::move(v);
+        }
     }
+
+    static void set_baseline(CacheEntry&, const T& v) { value_slot<KeyType>.baseline = v; }
+    static bool differs_from_baseline(const CacheEntry&, const T& v) { return differs<KeyType>(v, value_slot<KeyType>.baseline); }
+
+    template<typename Fn>
+    static void modify(CacheEntry& entry, Fn&& fn) {
+        if constexpr (lock_free) {
+            T v = value(entry);  // Readers never see a half-applied update
+            fn(v);
+            set_value(entry, v);
+        } else {
+            fn(value_slot<KeyType>.value);
+        }
+    }
+
+    /// Writer lock: entry stripe for lock-free values, per-key Mutex otherwise
+    static auto lock(const CacheEntry& entry) {
+        if constexpr (lock_free) {
+            return std::unique_lock<SpinLock>(entry_lock(&entry));
+        } else {
+            return std::unique_lock<Mutex>(value_slot<KeyType>.mutex);
+        }
+    }
+
+    /// Reader lock: none for lock-free values
+    static auto read_lock(const CacheEntry& entry) {
+        if constexpr (lock_free) {
+            return NoLock{};
+        } else {
+            return lock(entry);
+        }
+    }
+};
+
+template<typename KeyType>
+struct SlotAccess<KeyType, bool, false> {
+    static constexpr bool lock_free = true;
+
+    static bool value(const CacheEntry& entry) { return entry.test(CacheEntry::BOOL_VALUE); }
+    static void set_value(CacheEntry& entry, bool v) { entry.assign(CacheEntry::BOOL_VALUE, v); }
+    static void set_baseline(CacheEntry& entry, bool v) { entry.assign(CacheEntry::BOOL_BASELINE, v); }
+    static bool differs_from_baseline(const CacheEntry& entry, bool v) { return v != entry.test(CacheEntry::BOOL_BASELINE); }
+
+    template<typename Fn>
+    static void modify(CacheEntry& entry, Fn&& fn) {
+        bool v = value(entry);  // Bits can't be referenced; copy in and out
+        fn(v);
+        set_value(entry, v);
+    }
+
+    static auto lock(const CacheEntry& entry) { return std::unique_lock<SpinLock>(entry_lock(&entry)); }
+    static NoLock read_lock(const CacheEntry&) { return {}; }
+};
+
+template<typename KeyType>
+struct SlotAccess<KeyType, String, true> {
+    static constexpr bool lock_free = false;
+
+    static const String& value(const CacheEntry&) { return value_slot<KeyType>.value; }
+    static void set_value(CacheEntry&, const String& v) { value_slot<KeyType>.value = v; }
+    static void set_value(CacheEntry&, String&& v) { value_slot<KeyType>.value = std::move(v); }
+
+    static void set_baseline(CacheEntry&, const String& v) {
+        value_slot<KeyType>.baseline_length = v.length();
+        value_slot<KeyType>.baseline_hash = fnv1a(v.c_str(), v.length());
+    }
+
+    static bool differs_from_baseline(const CacheEntry&, const String& v) {
+        const auto& slot = value_slot<KeyType>;
+        return v.length() != slot.baseline_length || fnv1a(v.c_str(), v.length()) != slot.baseline_hash;
+    }
+
+    template<typename Fn> static void modify(CacheEntry&, Fn&& fn) { fn(value_slot<KeyType>.value); }
+
+    static auto lock(const CacheEntry&) { return std::unique_lock<Mutex>(value_slot<KeyType>.mutex); }
+    static auto read_lock(const CacheEntry& entry) { return lock(entry); }
 };
 
 /**
@@ -71,25 +347,150 @@ struct CacheEntry {
  *
  * Default is 64. Override by defining QPREFERENCES_MAX_KEYS via build flags
  * (e.g., -DQPREFERENCES_MAX_KEYS=96) to increase capacity.
+ * With QPREFERENCES_USE_REGISTRY the default is 0: a PrefRegistry provides
+ * exactly-sized storage instead.
  */
 #ifndef QPREFERENCES_MAX_KEYS
+#ifdef QPREFERENCES_USE_REGISTRY
+#define QPREFERENCES_MAX_KEYS 0
+#else
 #define QPREFERENCES_MAX_KEYS 64
 #endif
+#endif
 static constexpr size_t MAX_KEYS = QPREFERENCES_MAX_KEYS;
 
+/// Key ID of a key type that has not been registered yet
+static constexpr size_t UNREGISTERED_KEY = static_cast<size_t>(-1);
+
 /**
- * @brief Global cache storage for all preference entries.
+ * @brief Maximum number of distinct namespaces tracked for negative caching.
  *
- * Inline variable ensures single shared definition across translation units
- * (C++17 feature). Do NOT use 'static inline' as that creates separate
- * copies per translation unit.
+ * Default is 16. Override by defining QPREFERENCES_MAX_NAMESPACES via build flags.
+ * Namespaces beyond the limit still work, but are not negative-cached.
  */
-inline std::array<CacheEntry, MAX_KEYS> cache_entries;
+#ifndef QPREFERENCES_MAX_NAMESPACES
+#define QPREFERENCES_MAX_NAMESPACES 16
+#endif
+static constexpr size_t MAX_NAMESPACES = QPREFERENCES_MAX_NAMESPACES;
+
+/// Namespace index for namespaces beyond MAX_NAMESPACES (not tracked)
+static constexpr size_t UNTRACKED_NAMESPACE = MAX_NAMESPACES;
 
 /**
- * @brief Counter for assigning unique IDs to preference keys.
+ * @brief Per-namespace runtime state.
+ *
+ * Each distinct namespace is interned once at key registration; keys store
+ * the resulting small index, so namespace grouping and filtering are integer
+ * compares. Lookups by name compare the compile-time FNV-1a hash first.
+ *
+ * known_absent remembers that a read-only open failed because the namespace
+ * is not in NVS (e.g. on a factory-fresh device), so later first-access
+ * loads can skip NVS entirely. Other open failures are not remembered.
+ * Cleared when a read-write open creates the namespace. Only
+ * accessed around NVS opens, under nvs_mutex.
  */
-inline size_t next_key_id = 0;
+struct NamespaceState {
+    const char* name = nullptr;
+    uint32_t hash = 0;
+    bool known_absent = false;
+};
+
+/**
+ * @brief Global namespace state storage, indexed by KeyMetadata::namespace_index.
+ */
+inline std::array<NamespaceState, MAX_NAMESPACES> namespace_states;
+
+/**
+ * @brief Number of namespaces registered in namespace_states.
+ */
+inline size_t namespace_count = 0;
+
+/**
+ * @brief Find a registered namespace by name and hash.
+ * @param ns The namespace name
+ * @param hash fnv1a(ns)
+ * @return Index into namespace_states, or UNTRACKED_NAMESPACE if not registered
+ */
+inline size_t find_namespace(const char* ns, uint32_t hash) {
+    size_t count = atomic_read(namespace_count);
+    for (size_t i = 0; i < count; ++i) {
+        // Hash compare first; strcmp only confirms a match
+        if (namespace_states[i].hash == hash && std::strcmp(namespace_states[i].name, ns) == 0) {
+            return i;
+        }
+    }
+    return UNTRACKED_NAMESPACE;
+}
+
+/**
+ * @brief Find a registered namespace by name.
+ * @param ns The namespace name
+ * @return Index into namespace_states, or UNTRACKED_NAMESPACE if not registered
+ */
+inline size_t find_namespace(const char* ns) {
+    return find_namespace(ns, fnv1a(ns));
+}
+
+/**
+ * @brief Find or add a namespace in namespace_states (namespace interning).
+ * @param ns The namespace name
+ * @param hash Compile-time hash of ns (PrefKey::namespace_hash)
+ * @return Index into namespace_states, or UNTRACKED_NAMESPACE if the table is full
+ */
+inline size_t register_namespace(const char* ns, uint32_t hash) {
+    size_t index = find_namespace(ns, hash);
+    if (index != UNTRACKED_NAMESPACE) {
+        return index;
+    }
+    if (namespace_count >= MAX_NAMESPACES) {
+        return UNTRACKED_NAMESPACE;  // Still usable, just never negative-cached
+    }
+    size_t added = namespace_count;
+    namespace_states[added] = {ns, hash, false};
+    atomic_write(namespace_count, added + 1);  // Publish after the entry is complete
+    return added;
+}
+
+/**
+ * @brief Check whether a namespace is known not to exist in NVS.
+ * @param ns_index Index from KeyMetadata::namespace_index
+ */
+inline bool is_namespace_absent(size_t ns_index) {
+    return ns_index < atomic_read(namespace_count) && namespace_states[ns_index].known_absent;
+}
+
+/**
+ * @brief Record whether a namespace exists in NVS.
+ * @param ns_index Index from KeyMetadata::namespace_index
+ * @param absent true once NVS reported the namespace missing, false once it exists
+ */
+inline void set_namespace_absent(size_t ns_index, bool absent) {
+    if (ns_index < atomic_read(namespace_count)) {
+        namespace_states[ns_index].known_absent = absent;
+    }
+}
+
+struct SaveReport;
+
+/**
+ * @brief Type-erased operations for a preference key type.
+ *
+ * One table is instantiated per PrefKey type (see KeyOps.h) so that runtime
+ * loops such as preload() can act on a cache entry without template context.
+ */
+struct KeyOps {
+    /// Fill entry from an open namespace handle (nullptr = namespace missing)
+    void (*load)(Preferences* prefs, CacheEntry& entry, const void* key);
+
+    /// Persist the cached value to an open read-write namespace: remove the key
+    /// if it equals its default, otherwise write it. Updates the baseline, the
+    /// dirty flag and the written/removed/bytes_written counts of report
+    void (*persist)(Preferences& prefs, CacheEntry& entry, const void* key, SaveReport& report);
+
+    /// Write the namespace's packed bools after persist() calls (nullptr for
+    /// keys with their own NVS entry). Call before closing the namespace
+    void (*flush)(Preferences& prefs, SaveReport& report);
+};
 
 /**
  * @brief Metadata for a preference key, storing namespace and key name pointers.
@@ -100,14 +501,220 @@ inline size_t next_key_id = 0;
 struct KeyMetadata {
     const char* namespace_name = nullptr;
     const char* key_name = nullptr;
+    const void* key = nullptr;       ///< Library-owned copy of the PrefKey (source of default value)
+    const KeyOps* ops = nullptr;     ///< Type-erased operations for this key's value type
+    size_t namespace_index = UNTRACKED_NAMESPACE;  ///< Index into namespace_states
+};
+
+/**
+ * @brief Check whether a key belongs to a namespace.
+ *
+ * Compares interned namespace indices; only untracked namespaces (beyond
+ * MAX_NAMESPACES) fall back to a string comparison.
+ *
+ * @param meta The key's metadata
+ * @param ns_index Interned namespace index (from find_namespace())
+ * @param ns The namespace name (used only for untracked namespaces)
+ */
+inline bool in_namespace(const KeyMetadata& meta, size_t ns_index, const char* ns) {
+    if (meta.namespace_index != ns_index) {
+        return false;
+    }
+    return ns_index != UNTRACKED_NAMESPACE || std::strcmp(meta.namespace_name, ns) == 0;
+}
+
+/**
+ * @brief Check whether two keys belong to the same namespace.
+ */
+inline bool same_namespace(const KeyMetadata& a, const KeyMetadata& b) {
+    return in_namespace(a, b.namespace_index, b.namespace_name);
+}
+
+/**
+ * @brief Backing storage for a fixed number of preference keys.
+ *
+ * Parallel arrays: the same index maps to the same key. The library uses
+ * default_storage (QPREFERENCES_MAX_KEYS slots) unless a PrefRegistry
+ * installs exactly-sized storage of its own (see Registry.h).
+ *
+ * One extra slot at index N is the overflow slot: keys beyond the capacity,
+ * or keys missing from a PrefRegistry, land there instead of indexing out
+ * of bounds. It is never registered, iterated or tracked as dirty, and
+ * its status bits belong to the key that used it last (the owner recorded
+ * in its metadata).
+ *
+ * @tparam N Number of key slots
+ */
+template<size_t N>
+struct KeyStorage {
+    std::array<CacheEntry, N + 1> entries;
+    std::array<KeyMetadata, N + 1> metadata;
+    std::array<uint32_t, (N + 1 + 31) / 32> dirty_bits{};  ///< One bit per key, see mark_dirty()
+    std::array<uint32_t, N + 1> write_counts{};            ///< NVS writes per key, see count_write()
 };
 
+/**
+ * @brief Default storage sized by QPREFERENCES_MAX_KEYS.
+ *
+ * Inline variable ensures single shared definition across translation units
+ * (C++17 feature). Do NOT use 'static inline' as that creates separate
+ * copies per translation unit.
+ */
+inline KeyStorage<MAX_KEYS> default_storage;
+
+/**
+ * @brief Global cache storage for all preference entries (active storage).
+ */
+inline CacheEntry* cache_entries = default_storage.entries.data();
+
 /**
  * @brief Global metadata storage for all preference keys.
  *
  * Parallel array to cache_entries - same index maps to same key.
  */
-inline std::array<KeyMetadata, MAX_KEYS> key_metadata;
+inline KeyMetadata* key_metadata = default_storage.metadata.data();
+
+/**
+ * @brief Bitmap of dirty cache entries, one bit per key.
+ *
+ * Mirrors CacheEntry::dirty so save() visits only dirty slots and
+ * anyDirty() is O(1). Always update through mark_dirty().
+ */
+inline uint32_t* dirty_bits = default_storage.dirty_bits.data();
+
+/**
+ * @brief NVS writes (puts and removals) per key, parallel to cache_entries.
+ *
+ * Counts since boot, plus the persisted totals once loadWearCounters()
+ * (or saveWearCounters()) has merged them in.
+ */
+inline uint32_t* write_counts = default_storage.write_counts.data();
+
+/**
+ * @brief Number of key slots in the active storage (also the overflow slot's index).
+ */
+inline size_t key_capacity = MAX_KEYS;
+
+/**
+ * @brief Counter for assigning unique IDs to preference keys.
+ */
+inline size_t next_key_id = 0;
+
+/**
+ * @brief Switch the active storage to a caller-provided KeyStorage.
+ *
+ * Must run before any key is registered (used by PrefRegistry during
+ * static initialization).
+ *
+ * @tparam N Number of key slots
+ * @param storage Storage with static storage duration
+ */
+template<size_t N>
+void install_storage(KeyStorage<N>& storage) {
+    assert(next_key_id == 0 && "QPreferences: storage must be installed before keys register");
+    cache_entries = storage.entries.data();
+    key_metadata = storage.metadata.data();
+    dirty_bits = storage.dirty_bits.data();
+    write_counts = storage.write_counts.data();
+    key_capacity = N;
+}
+
+/**
+ * @brief Number of entries currently marked dirty (read with atomic_read).
+ */
+inline size_t dirty_count = 0;
+
+/**
+ * @brief Number of changes that left an entry dirty (wraps).
+ *
+ * Lets a write-back policy detect "still changing" without timestamping
+ * every set(): a differing value between two polls means activity.
+ */
+inline uint32_t change_count = 0;
+
+/**
+ * @brief Index of a cache entry in the active storage.
+ */
+inline size_t entry_id(const CacheEntry& entry) {
+    return static_cast<size_t>(&entry - cache_entries);
+}
+
+/**
+ * @brief Set or clear the dirty flag of a cache entry, keeping the bitmap in sync.
+ *
+ * In thread-safe builds the caller holds the key's SlotAccess lock, so the
+ * flag of one entry never flips concurrently; bitmap words and counters are
+ * shared between keys and updated atomically.
+ *
+ * @param id Index into cache_entries
+ * @param dirty New dirty state
+ */
+inline void mark_dirty(size_t id, bool dirty) {
+    auto& entry = cache_entries[id];
+    if (id >= key_capacity) {
+        entry.assign(CacheEntry::DIRTY, dirty);  // Overflow slot: never visited by save()
+        return;
+    }
+    if (dirty) {
+        atomic_add(change_count, uint32_t{1});
+    }
+    if (entry.is_dirty() == dirty) {
+        return;
+    }
+    entry.assign(CacheEntry::DIRTY, dirty);
+
+    uint32_t mask = uint32_t{1} << (id % 32);
+    if (dirty) {
+        atomic_fetch_or(dirty_bits[id / 32], mask);
+        atomic_add(dirty_count, size_t{1});
+    } else {
+        atomic_fetch_and(dirty_bits[id / 32], ~mask);
+        atomic_add(dirty_count, static_cast<size_t>(-1));
+    }
+}
+
+/**
+ * @brief Call fn(id) for every dirty entry, in index order.
+ *
+ * Skips clean words of the bitmap, so cost scales with the number of dirty
+ * keys. fn may clear the dirty flag of the visited entry.
+ *
+ * @tparam Fn Callable accepting (size_t id)
+ */
+template<typename Fn>
+void for_each_dirty(Fn fn) {
+    size_t words = (atomic_read(next_key_id) + 31) / 32;
+    for (size_t word = 0; word < words && atomic_read(dirty_count) != 0; ++word) {
+        uint32_t bits = atomic_read(dirty_bits[word]);
+        while (bits != 0) {
+            size_t id = word * 32 + static_cast<size_t>(__builtin_ctz(bits));
+            bits &= bits - 1;  // Clear lowest set bit
+            fn(id);
+        }
+    }
+}
+
+/**
+ * @brief First dirty entry (in index order) for which pred(id) returns true.
+ *
+ * @tparam Pred Callable accepting (size_t id), returning bool
+ * @return The entry index, or UNREGISTERED_KEY if there is none
+ */
+template<typename Pred>
+size_t find_dirty(Pred pred) {
+    size_t words = (atomic_read(next_key_id) + 31) / 32;
+    for (size_t word = 0; word < words && atomic_read(dirty_count) != 0; ++word) {
+        uint32_t bits = atomic_read(dirty_bits[word]);
+        while (bits != 0) {
+            size_t id = word * 32 + static_cast<size_t>(__builtin_ctz(bits));
+            bits &= bits - 1;
+            if (pred(id)) {
+                return id;
+            }
+        }
+    }
+    return UNREGISTERED_KEY;
+}
 
 /**
  * @brief Information about a preference, passed to forEach callbacks.
@@ -121,23 +728,111 @@ struct PrefInfo {
     size_t index;                 ///< Index into cache_entries array
     bool is_initialized;          ///< Whether key has been loaded from NVS
     bool is_dirty;                ///< Whether RAM differs from NVS
+    uint32_t write_count;         ///< NVS writes of this key (see write_counts)
+};
+
+/**
+ * @brief Flash wear summary across all keys, returned by wearReport().
+ */
+struct WearReport {
+    uint32_t total_writes = 0;            ///< NVS writes and removals of all keys
+    size_t hottest_index = UNREGISTERED_KEY;  ///< Key with the most writes (UNREGISTERED_KEY if none)
+    const char* hottest_namespace = nullptr;  ///< Its namespace
+    const char* hottest_key = nullptr;        ///< Its key name
+    uint32_t hottest_writes = 0;          ///< Its write count
+};
+
+/**
+ * @brief NVS namespace that saveWearCounters() persists write counts in.
+ *
+ * Override via build flags (e.g., -DQPREFERENCES_WEAR_NAMESPACE=\"wear\").
+ * Must not be used by any PrefKey.
+ */
+#ifndef QPREFERENCES_WEAR_NAMESPACE
+#define QPREFERENCES_WEAR_NAMESPACE "qprefs_wear"
+#endif
+
+/**
+ * @brief One persisted write count, matched to its key by name hash.
+ *
+ * Slot indices depend on registration order, which can change between
+ * firmware versions; the namespace/key hash doesn't.
+ */
+struct WearRecord {
+    uint32_t key_hash;   ///< wear_key_hash() of the key
+    uint32_t writes;     ///< Persisted write count
+};
+
+/// Keys [0, wear_merged_keys) have had their persisted wear counts merged into write_counts
+inline size_t wear_merged_keys = 0;
+
+/**
+ * @brief Stable identity of a key for wear records: FNV-1a of "namespace/key".
+ */
+inline uint32_t wear_key_hash(const KeyMetadata& meta) {
+    return fnv1a_append(fnv1a_append(fnv1a(meta.namespace_name), "/"), meta.key_name);
+}
+
+/**
+ * @brief Record one NVS write (or removal) of a key.
+ * @param id Index into cache_entries
+ */
+inline void count_write(size_t id) {
+    atomic_add(write_counts[id], uint32_t{1});
+}
+
+/**
+ * @brief Limits for one incremental saveStep() call. Zero means unlimited.
+ *
+ * At least one key is written per call, so progress is guaranteed even if
+ * a single NVS commit exceeds max_us.
+ */
+struct SaveBudget {
+    size_t max_keys = 0;   ///< Stop after writing this many keys
+    uint32_t max_us = 0;   ///< Stop once this many microseconds have elapsed
+};
+
+/**
+ * @brief I/O statistics of one save(), save(key) or saveStep() call.
+ *
+ * Usage:
+ *   auto report = QPrefs::save();
+ *   Serial.printf("%u keys, %u bytes in %u us\n",
+ *       report.written, report.bytes_written, report.elapsed_us);
+ */
+struct SaveReport {
+    size_t written = 0;            ///< Keys written to NVS
+    size_t removed = 0;            ///< Keys removed from NVS because they equal their default
+    size_t skipped = 0;            ///< Keys not persisted: the clean key passed to save(key), or namespace failed to open (left dirty)
+    size_t deferred = 0;           ///< Keys held back by min_interval_ms or the write budget (left dirty)
+    size_t namespaces_opened = 0;  ///< Successful read-write namespace opens
+    size_t bytes_written = 0;      ///< Sum of byte counts returned by Preferences put calls
+    uint32_t elapsed_us = 0;       ///< Wall time of the call in microseconds
 };
 
 /**
  * @brief Register a new preference key and get its unique ID.
+ *
+ * Caller holds registry_lock. The slot is published by the release store
+ * to next_key_id, after its metadata is complete.
+ *
  * @param ns The namespace name for this key
- * @param key The key name within the namespace
+ * @param ns_hash Compile-time hash of the namespace name
+ * @param key_name The key name within the namespace
+ * @param key The PrefKey instance (static storage: see QPrefs::detail::stored_key())
+ * @param ops Type-erased operations for the key's value type
  * @return Unique ID for this key (index into cache_entries array)
  */
-inline size_t register_key(const char* ns, const char* key) {
+inline size_t register_key(const char* ns, uint32_t ns_hash, const char* key_name, const void* key, const KeyOps* ops) {
     // Guard against exceeding configured capacity; fail-fast in debug.
-    assert(next_key_id < MAX_KEYS && "QPreferences: preference key limit exceeded (increase QPREFERENCES_MAX_KEYS)");
-    if (next_key_id >= MAX_KEYS) {
-        // Fail-safe: avoid out-of-bounds write. Reuse last valid index.
-        return MAX_KEYS - 1;
+    assert(next_key_id < key_capacity && "QPreferences: preference key limit exceeded (increase QPREFERENCES_MAX_KEYS)");
+    if (next_key_id >= key_capacity) {
+        // Fail-safe: avoid out-of-bounds write. The key lives in the overflow slot.
+        return key_capacity;
     }
-    size_t id = next_key_id++;
-    key_metadata[id] = {ns, key};
+    size_t id = next_key_id;
+    key_metadata[id] = {ns, key_name, key, ops, register_namespace(ns, ns_hash)};
+    atomic_write(next_key_id, id + 1);
     return id;
 }
 
@@ -0,0 +1,89 @@
+#ifndef QPREFERENCES_FIXEDSTRING_H
+#define QPREFERENCES_FIXEDSTRING_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace QPreferences {
+
+/**
+ * @brief String with inline storage for up to N characters (no heap).
+ *
+ * A drop-in value type for string preferences in builds that forbid heap
+ * use after init: the cached value, its baseline and every get() copy live
+ * in a char[N + 1]. Stored in NVS as a regular string (putString), so a key
+ * can switch between String and FixedString without migrating data.
+ *
+ * Usage:
+ *   PrefKey<FixedString<32>, "wifi", "ssid"> ssidKey{"default"};  // Length checked at compile time
+ *   QPrefs::update(ssidKey, [](auto& s) { s.assign("home"); });
+ *
+ * @tparam N Capacity in characters, excluding the terminating NUL
+ */
+template<size_t N>
+class FixedString {
+public:
+    static_assert(N > 0, "FixedString capacity must be at least 1");
+
+    /// Maximum length in characters
+    static constexpr size_t capacity = N;
+
+    constexpr FixedString() = default;
+
+    /**
+     * @brief Construct from a string literal, checking its length at compile time.
+     */
+    template<size_t M>
+    constexpr FixedString(const char (&str)[M]) {
+        static_assert(M - 1 <= N, "FixedString: literal longer than capacity");
+        for (size_t i = 0; i < M; ++i) {
+            data_[i] = str[i];
+        }
+    }
+
+    /**
+     * @brief Replace the contents, truncating to capacity.
+     * @param str NUL-terminated source (nullptr = empty)
+     * @return true if str fit without truncation
+     */
+    bool assign(const char* str) {
+        size_t length = str != nullptr ? std::strlen(str) : 0;
+        bool fits = length <= N;
+        if (!fits) {
+            length = N;
+        }
+        if (length != 0) {
+            std::memcpy(data_, str, length);
+        }
+        data_[length] = '\0';
+        return fits;
+    }
+
+    const char* c_str() const { return data_; }
+    size_t length() const { return std::strlen(data_); }
+    bool isEmpty() const { return data_[0] == '\0'; }
+
+    /// Writable buffer of capacity + 1 bytes (keep it NUL-terminated)
+    char* data() { return data_; }
+
+    friend bool operator==(const FixedString& a, const FixedString& b) {
+        return std::strcmp(a.data_, b.data_) == 0;
+    }
+
+private:
+    char data_[N + 1] = {};
+};
+
+/**
+ * @brief Whether T is a FixedString.
+ */
+template<typename T>
+inline constexpr bool is_fixed_string = false;
+
+template<size_t N>
+inline constexpr bool is_fixed_string<FixedString<N>> = true;
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_FIXEDSTRING_H
@@ -0,0 +1,144 @@
+#ifndef QPREFERENCES_FIXEDVECTOR_H
+#define QPREFERENCES_FIXEDVECTOR_H
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+namespace QPreferences {
+
+/**
+ * @brief Variable-length array with inline storage for up to N elements (no heap).
+ *
+ * For preferences whose length varies at runtime, such as schedule tables.
+ * Stored in NVS as one blob holding the length and only the used elements,
+ * and read straight back into the cache slot.
+ *
+ * Usage:
+ *   PrefKey<FixedVector<uint16_t, 48>, "sched", "times"> timesKey{{360, 1080}};
+ *   QPrefs::update(timesKey, [](auto& v) { v.push_back(1320); });
+ *   QPrefs::set(timesKey, 0, uint16_t{420});  // Element write
+ *
+ * @tparam T Trivially copyable element type
+ * @tparam N Capacity in elements
+ */
+template<typename T, size_t N>
+class FixedVector {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "FixedVector elements must be trivially copyable");
+    static_assert(N > 0, "FixedVector capacity must be at least 1");
+
+    using value_type = T;
+
+    /// Maximum number of elements
+    static constexpr size_t capacity = N;
+
+    constexpr FixedVector() = default;
+
+    /**
+     * @brief Construct from a list of elements (extra elements are dropped; asserts in debug builds).
+     */
+    constexpr FixedVector(std::initializer_list<T> init) {
+        assert(init.size() <= N && "FixedVector: initializer longer than capacity");
+        for (const T& element : init) {
+            if (size_ == N) {
+                break;
+            }
+            data_[size_++] = element;
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    /**
+     * @brief Append an element.
+     * @return false if the vector is full (nothing appended)
+     */
+    bool push_back(const T& element) {
+        if (size_ == N) {
+            return false;
+        }
+        data_[size_++] = element;
+        return true;
+    }
+
+    /**
+     * @brief Change the length; new elements are value-initialized.
+     * @return false if count exceeds the capacity (nothing changed)
+     */
+    bool resize(size_t count) {
+        if (count > N) {
+            return false;
+        }
+        for (size_t i = size_; i < count; ++i) {
+            data_[i] = T{};
+        }
+        size_ = static_cast<uint32_t>(count);
+        return true;
+    }
+
+    void clear() { size_ = 0; }
+
+    /**
+     * @brief Bytes stored in NVS: the length header plus the used elements.
+     */
+    size_t stored_size() const {
+        return reinterpret_cast<const char*>(data_ + size_) - reinterpret_cast<const char*>(this);
+    }
+
+    friend bool operator==(const FixedVector& a, const FixedVector& b) {
+        if (a.size_ != b.size_) {
+            return false;
+        }
+        if constexpr (std::equality_comparable<T>) {
+            for (size_t i = 0; i < a.size_; ++i) {
+                if (!(a.data_[i] == b.data_[i])) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            return std::memcmp(a.data_, b.data_, a.size_ * sizeof(T)) == 0;
+        }
+    }
+
+private:
+    uint32_t size_ = 0;
+    T data_[N] = {};
+};
+
+/**
+ * @brief Whether T is a FixedVector.
+ */
+template<typename T>
+inline constexpr bool is_fixed_vector = false;
+
+template<typename T, size_t N>
+inline constexpr bool is_fixed_vector<FixedVector<T, N>> = true;
+
+/**
+ * @brief Whether T supports element access through set(key, index, value).
+ */
+template<typename T>
+inline constexpr bool is_element_container = is_fixed_vector<T>;
+
+template<typename T, size_t N>
+inline constexpr bool is_element_container<std::array<T, N>> = std::is_trivially_copyable_v<T>;
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_FIXEDVECTOR_H
@@ -0,0 +1,586 @@
+#ifndef QPREFERENCES_KEYOPS_H
+#define QPREFERENCES_KEYOPS_H
+
+#include <Preferences.h>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "CacheEntry.h"
+#include "PackedBools.h"
+#include "RateLimit.h"
+
+#if defined(ESP_PLATFORM)
+#include <nvs.h>
+#endif
+
+namespace QPreferences {
+
+/**
+ * @brief Whether T is an integer type stored in exactly its own width.
+ *
+ * Each maps onto the matching NVS primitive (putUChar, putShort, putLong64, ...),
+ * so a uint8_t key moves one byte instead of four.
+ */
+template<typename T>
+inline constexpr bool is_nvs_integer =
+    std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t> ||
+    std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, int> || std::is_same_v<T, unsigned> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>;
+
+/**
+ * @brief Whether values of type T are read from NVS straight into their cache slot.
+ */
+template<typename T>
+inline constexpr bool reads_in_place = is_blob_value<T> || is_fixed_string<T> || is_fixed_vector<T>;
+
+/**
+ * @brief Read a blob struct, FixedString or FixedVector in place.
+ *
+ * Blobs must have exactly sizeof(T) bytes; strings and vectors must fit
+ * the capacity.
+ *
+ * @return true if out was filled (false: missing, too long, or stored by a different layout)
+ */
+template<typename T>
+bool read_in_place(Preferences& prefs, const char* key_name, T& out) {
+    if constexpr (is_fixed_string<T>) {
+        // Fails without touching the buffer if the stored string doesn't fit
+        return prefs.getString(key_name, out.data(), T::capacity + 1) > 0;
+    } else if constexpr (is_fixed_vector<T>) {
+        // Length header + used elements; validated after the read
+        size_t length = prefs.getBytesLength(key_name);
+        if (length < sizeof(uint32_t) || length > sizeof(T) ||
+            prefs.getBytes(key_name, &out, length) != length) {
+            return false;
+        }
+        return out.size() <= T::capacity && out.stored_size() == length;
+    } else {
+        return prefs.getBytesLength(key_name) == sizeof(T) &&
+               prefs.getBytes(key_name, &out, sizeof(T)) == sizeof(T);
+    }
+}
+
+/**
+ * @brief Read a typed value from an open Preferences namespace.
+ *
+ * @tparam T The value type (an is_nvs_integer type, float, bool, String, is_blob_value struct)
+ * @param prefs Open Preferences handle
+ * @param key_name The key name within the namespace
+ * @param default_value Value returned if the read fails
+ * @return The stored value, or default_value
+ */
+template<typename T>
+T read_value(Preferences& prefs, const char* key_name, const T& default_value) {
+    if constexpr (is_nvs_integer<T> && sizeof(T) == 1) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.getChar(key_name, default_value);
+        } else {
+            return prefs.getUChar(key_name, default_value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 2) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.getShort(key_name, default_value);
+        } else {
+            return prefs.getUShort(key_name, default_value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 4) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.getInt(key_name, default_value);
+        } else {
+            return prefs.getUInt(key_name, default_value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 8) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.getLong64(key_name, default_value);
+        } else {
+            return prefs.getULong64(key_name, default_value);
+        }
+    } else if constexpr (std::is_same_v<T, float>) {
+        return prefs.getFloat(key_name, default_value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return prefs.getBool(key_name, default_value);
+    } else if constexpr (std::is_same_v<T, String>) {
+        return prefs.getString(key_name, default_value);
+    } else if constexpr (reads_in_place<T>) {
+        T value = default_value;
+        read_in_place(prefs, key_name, value);
+        return value;
+    } else {
+        static_assert(sizeof(T) == 0, "Unsupported type for QPreferences: supported types are int8_t-int64_t, uint8_t-uint64_t, float, bool, String, FixedString<N>, FixedVector<T, N>, trivially copyable structs (std::array)");
+    }
+}
+
+/**
+ * @brief Write a typed value to an open (read-write) Preferences namespace.
+ *
+ * @tparam T The value type (an is_nvs_integer type, float, bool, String, is_blob_value struct)
+ * @param prefs Open Preferences handle
+ * @param key_name The key name within the namespace
+ * @param value The value to write
+ * @return Bytes written as reported by Preferences (0 on failure)
+ */
+template<typename T>
+size_t write_value(Preferences& prefs, const char* key_name, const T& value) {
+    if constexpr (is_nvs_integer<T> && sizeof(T) == 1) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.putChar(key_name, value);
+        } else {
+            return prefs.putUChar(key_name, value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 2) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.putShort(key_name, value);
+        } else {
+            return prefs.putUShort(key_name, value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 4) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.putInt(key_name, value);
+        } else {
+            return prefs.putUInt(key_name, value);
+        }
+    } else if constexpr (is_nvs_integer<T> && sizeof(T) == 8) {
+        if constexpr (std::is_signed_v<T>) {
+            return prefs.putLong64(key_name, value);
+        } else {
+            return prefs.putULong64(key_name, value);
+        }
+    } else if constexpr (std::is_same_v<T, float>) {
+        return prefs.putFloat(key_name, value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return prefs.putBool(key_name, value);
+    } else if constexpr (std::is_same_v<T, String>) {
+        return prefs.putString(key_name, value);
+    } else if constexpr (is_fixed_string<T>) {
+        return prefs.putString(key_name, value.c_str());
+    } else if constexpr (is_fixed_vector<T>) {
+        return prefs.putBytes(key_name, &value, value.stored_size());
+    } else if constexpr (is_blob_value<T>) {
+        return prefs.putBytes(key_name, &value, sizeof(T));
+    } else {
+        static_assert(sizeof(T) == 0, "Unsupported type for QPreferences: supported types are int8_t-int64_t, uint8_t-uint64_t, float, bool, String, FixedString<N>, FixedVector<T, N>, trivially copyable structs (std::array)");
+    }
+}
+
+/**
+ * @brief Initialize a cache entry from NVS.
+ *
+ * Reads the key if it exists in the namespace, otherwise falls back to the
+ * default value and clears has_nvs_value. A stored blob or string that no
+ * longer fits the type (struct layout or capacity changed) loads the
+ * default and leaves the key dirty, so the next save replaces or removes
+ * it. Otherwise clears the dirty flag (used by factoryReset() on loaded
+ * entries). Marks the entry initialized last, so a reader that sees it
+ * initialized also sees the value.
+ * The NVS read happens before the key's lock is taken, except for blob
+ * structs and FixedStrings, which are read straight into the cache slot
+ * under the key's Mutex (no temporary copy). Packed bools read their bit
+ * from the namespace's packed image, loading it on first use (a key whose
+ * pack_bit clashes with another key's reads its default).
+ *
+ * @tparam KeyType The PrefKey type
+ * @param prefs Open read-only namespace handle, or nullptr if the namespace doesn't exist
+ * @param entry The cache entry to fill
+ * @param key Pointer to the KeyType instance (provides the default value)
+ */
+template<typename KeyType>
+void load_entry(Preferences* prefs, CacheEntry& entry, const void* key) {
+    using T = typename KeyType::value_type;
+    using Slot = SlotAccess<KeyType>;
+    const T& default_value = static_cast<const KeyType*>(key)->default_value;
+
+    if constexpr (is_packed_bool<KeyType>) {
+        auto& state = packed_state<KeyType>();
+        load_packed_bools(state, prefs);
+
+        constexpr uint64_t bit = uint64_t{1} << KeyType::options.pack_bit;
+        bool present = !pack_bit_clash<KeyType> && (state.bits.present & bit) != 0;
+        bool stored = present ? (state.bits.values & bit) != 0 : default_value;
+        auto guard = Slot::lock(entry);
+        Slot::set_baseline(entry, stored);
+        Slot::set_value(entry, stored);
+        entry.set_has_nvs_value(present);
+        entry.set_stale(false);
+        mark_dirty(entry_id(entry), false);
+    } else if (prefs != nullptr && prefs->isKey(KeyType::key_name)) {
+        // Checked before reading (avoids NVS error logging for missing keys)
+        if constexpr (reads_in_place<T>) {
+            auto guard = Slot::lock(entry);
+            auto& value = value_slot<KeyType>.value;
+            bool stored = read_in_place(*prefs, KeyType::key_name, value);
+            if (!stored) {
+                value = default_value;  // Layout or capacity changed since it was saved
+            }
+            Slot::set_baseline(entry, value);
+            entry.set_has_nvs_value(true);  // Key exists in NVS, readable or not
+            entry.set_stale(!stored);
+            mark_dirty(entry_id(entry), !stored);  // Stale: next save rewrites or removes it
+        } else {
+            T stored = read_value<T>(*prefs, KeyType::key_name, default_value);
+            auto guard = Slot::lock(entry);
+            Slot::set_baseline(entry, stored);
+            Slot::set_value(entry, std::move(stored));
+            entry.set_has_nvs_value(true);  // Key exists in NVS
+            entry.set_stale(false);
+            mark_dirty(entry_id(entry), false);
+        }
+    } else {
+        auto guard = Slot::lock(entry);
+        Slot::set_value(entry, default_value);
+        entry.set_has_nvs_value(false);  // Nothing in NVS for this key
+        entry.set_stale(false);
+        mark_dirty(entry_id(entry), false);
+    }
+
+    entry.set_initialized();
+}
+
+/**
+ * @brief Write a cached value to NVS and make it the new baseline.
+ *
+ * Clears the dirty flag unless the value changed while it was being
+ * written (thread-safe builds write a snapshot taken under the key's lock,
+ * so the NVS commit never runs inside it).
+ *
+ * @tparam KeyType The PrefKey type
+ * @param prefs Namespace handle opened read-write
+ * @param entry The cache entry to persist
+ * @return Bytes written as reported by Preferences
+ */
+template<typename KeyType>
+size_t store_entry(Preferences& prefs, CacheEntry& entry) {
+    using T = typename KeyType::value_type;
+    using Slot = SlotAccess<KeyType>;
+
+    if constexpr (thread_safe) {
+        T snapshot = [&] {
+            auto guard = Slot::lock(entry);
+            return T(Slot::value(entry));
+        }();
+        size_t bytes = write_value<T>(prefs, KeyType::key_name, snapshot);
+
+        auto guard = Slot::lock(entry);
+        Slot::set_baseline(entry, snapshot);
+        entry.set_has_nvs_value(true);
+        entry.set_stale(false);
+        mark_dirty(entry_id(entry), Slot::differs_from_baseline(entry, Slot::value(entry)));
+        return bytes;
+    } else {
+        size_t bytes = write_value<T>(prefs, KeyType::key_name, Slot::value(entry));
+        Slot::set_baseline(entry, Slot::value(entry));
+        entry.set_has_nvs_value(true);
+        entry.set_stale(false);
+        mark_dirty(entry_id(entry), false);
+        return bytes;
+    }
+}
+
+/**
+ * @brief Persist a cache entry, removing it from NVS if it equals the default.
+ *
+ * Shared by save(key), batch save() and saveStep() (PERS-04): a key whose
+ * value is back at its default is erased instead of rewritten. Writes
+ * refused by admit_write() are deferred: the key stays dirty. Packed bools
+ * only update the namespace's packed image; KeyOps::flush writes it, and
+ * the budget and write count are charged once per flush, by its first key.
+ *
+ * @tparam KeyType The PrefKey type
+ * @param prefs Namespace handle opened read-write
+ * @param entry The (dirty) cache entry to persist
+ * @param key Pointer to the KeyType instance (provides the default value)
+ * @param report Receives written/removed/deferred/bytes_written counts
+ */
+template<typename KeyType>
+void persist_entry(Preferences& prefs, CacheEntry& entry, const void* key, SaveReport& report) {
+    using Slot = SlotAccess<KeyType>;
+    const auto& default_value = static_cast<const KeyType*>(key)->default_value;
+
+    if constexpr (is_packed_bool<KeyType>) {
+        auto& state = packed_state<KeyType>();
+        constexpr uint64_t bit = uint64_t{1} << KeyType::options.pack_bit;
+        if (pack_bit_clash<KeyType>) {
+            auto guard = Slot::lock(entry);
+            mark_dirty(entry_id(entry), false);  // Bit owned by another key: RAM only
+            return;
+        }
+
+        // The first packed key of a flush pays for the one blob write
+        bool opens_flush = !state.pending;
+        if (!admit_write<KeyType>(opens_flush)) {
+            ++report.deferred;  // Over min_interval_ms or the write budget; retried later
+            return;
+        }
+        {
+            auto guard = Slot::lock(entry);
+            bool value = Slot::value(entry);
+            state.bits.values &= ~bit;
+            if (value == default_value) {
+                state.bits.present &= ~bit;  // Reads its default again
+                ++report.removed;
+            } else {
+                state.bits.values |= value ? bit : 0;
+                state.bits.present |= bit;
+                Slot::set_baseline(entry, value);
+                ++report.written;
+            }
+            entry.set_has_nvs_value(value != default_value);
+            mark_dirty(entry_id(entry), false);
+        }
+        state.pending = true;
+        if (opens_flush) {
+            count_write(entry_id(entry));
+        }
+        return;
+    }
+
+    if (!admit_write<KeyType>()) {
+        ++report.deferred;  // Over min_interval_ms or the write budget; retried later
+        return;
+    }
+
+    bool is_default;
+    {
+        [[maybe_unused]] auto guard = Slot::read_lock(entry);
+        is_default = values_equal(Slot::value(entry), default_value);
+    }
+
+    if (is_default) {
+        prefs.remove(KeyType::key_name);
+
+        auto guard = Slot::lock(entry);
+        entry.set_has_nvs_value(false);  // Nothing in NVS; compare against default
+        entry.set_stale(false);
+        mark_dirty(entry_id(entry), differs<KeyType>(Slot::value(entry), default_value));  // Clean unless changed meanwhile
+        ++report.removed;
+    } else {
+        report.bytes_written += store_entry<KeyType>(prefs, entry);
+        ++report.written;
+    }
+    count_write(entry_id(entry));
+}
+
+/**
+ * @brief Check why a read-only open failed: true only if the namespace is missing.
+ *
+ * Preferences::begin() reports every failure as false. On ESP32 nvs_open()
+ * tells ESP_ERR_NVS_NOT_FOUND apart from transient errors (NVS not yet
+ * initialized, no free handles); elsewhere the cause is unknown.
+ *
+ * @param ns The namespace name
+ * @return true if the namespace definitely doesn't exist
+ */
+inline bool namespace_not_found(const char* ns) {
+#if defined(ESP_PLATFORM)
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(ns, NVS_READONLY, &handle);
+    if (err == ESP_OK) {
+        nvs_close(handle);  // Created since the failed begin()
+    }
+    return err == ESP_ERR_NVS_NOT_FOUND;
+#else
+    (void)ns;
+    return false;
+#endif
+}
+
+/**
+ * @brief Open a namespace read-only, consulting the negative cache.
+ *
+ * Skips NVS entirely if a previous open already found the namespace missing.
+ * A failed open is remembered only if the namespace is definitely missing,
+ * so a transient error doesn't hide stored values until the next write.
+ * Caller holds nvs_mutex.
+ *
+ * @param prefs Preferences handle to open
+ * @param ns The namespace name
+ * @param ns_index Index from KeyMetadata::namespace_index
+ * @return true if opened (caller must call end()), false if the namespace couldn't be opened
+ */
+inline bool begin_read(Preferences& prefs, const char* ns, size_t ns_index) {
+    if (is_namespace_absent(ns_index)) {
+        return false;
+    }
+    bool opened = prefs.begin(ns, true);  // true = read-only (doesn't create namespace)
+    if (!opened && namespace_not_found(ns)) {
+        set_namespace_absent(ns_index, true);
+    }
+    return opened;
+}
+
+/**
+ * @brief Open a namespace read-write, clearing its negative-cache state.
+ *
+ * Caller holds nvs_mutex.
+ *
+ * @param prefs Preferences handle to open
+ * @param ns The namespace name
+ * @param ns_index Index from KeyMetadata::namespace_index
+ * @return true if opened (the namespace now exists in NVS)
+ */
+inline bool begin_write(Preferences& prefs, const char* ns, size_t ns_index) {
+    bool opened = prefs.begin(ns, false);  // false = read-write (creates namespace)
+    if (opened) {
+        set_namespace_absent(ns_index, false);
+    }
+    return opened;
+}
+
+/**
+ * @brief Type-erased operations table for a PrefKey type.
+ */
+template<typename KeyType>
+inline constexpr KeyOps key_ops{
+    &load_entry<KeyType>,
+    &persist_entry<KeyType>,
+    is_packed_bool<KeyType> ? &flush_packed_bools<KeyType> : nullptr
+};
+
+} // namespace QPreferences
+
+namespace QPrefs {
+
+namespace detail {
+    /**
+     * @brief Cache slot index assigned to a preference key type.
+     *
+     * A constant-initialized inline variable template rather than a
+     * function-local static, so reading it needs no thread-safe static
+     * guard: the hot accessors pay a plain load and compare.
+     */
+    template<typename KeyType>
+    inline size_t key_id = QPreferences::UNREGISTERED_KEY;
+
+    /// Static storage for the library's copy of a key type's first instance
+    template<typename KeyType>
+    alignas(KeyType) inline unsigned char key_copy_buffer[sizeof(KeyType)];
+
+    /// The copy in key_copy_buffer, once constructed (read with atomic_read)
+    template<typename KeyType>
+    inline const KeyType* key_copy = nullptr;
+
+    /**
+     * @brief The library's copy of the first instance of a key type.
+     *
+     * KeyMetadata::key points here rather than at the caller's instance, so
+     * a key first used as a local or a temporary never leaves a dangling
+     * pointer for preload(), save() or factoryReset(). Constructed once in
+     * static storage and never destroyed; later instances share it.
+     *
+     * @tparam KeyType The PrefKey type
+     * @param key The instance to copy (first call only)
+     */
+    template<typename KeyType>
+    const KeyType* stored_key(const KeyType& key) {
+        const KeyType* copy = QPreferences::atomic_read(key_copy<KeyType>);
+        if (copy == nullptr) {
+            std::lock_guard<QPreferences::Mutex> guard(QPreferences::key_copy_mutex);
+            copy = key_copy<KeyType>;
+            if (copy == nullptr) {
+                copy = ::new (static_cast<void*>(key_copy_buffer<KeyType>)) KeyType(key);  // Copying doesn't register
+                QPreferences::atomic_write(key_copy<KeyType>, copy);
+            }
+        }
+        return copy;
+    }
+
+    /**
+     * @brief Register a key type (first call only) and return its cache ID.
+     *
+     * Records the namespace, key name, a copy of the key (stored_key()) and
+     * the operations table for runtime access by preload() and save().
+     * Called from the PrefKey
+     * constructor, so global keys are registered during static initialization,
+     * before their first access. Serialized by registry_lock, so two tasks
+     * racing on a lazily registered key get the same slot.
+     *
+     * @tparam KeyType The PrefKey type
+     * @param key The key instance (only the first instance seen is copied)
+     * @return Unique ID for this key (index into cache_entries array)
+     */
+    template<typename KeyType>
+    size_t register_key_type(const KeyType& key) {
+        const KeyType* copy = stored_key(key);  // Before registry_lock: may allocate
+        std::lock_guard<QPreferences::SpinLock> guard(QPreferences::registry_lock);
+        if (key_id<KeyType> == QPreferences::UNREGISTERED_KEY) {
+            QPreferences::atomic_write(key_id<KeyType>, QPreferences::register_key(
+                KeyType::namespace_name,
+                KeyType::namespace_hash,
+                KeyType::key_name,
+                copy,
+                &QPreferences::key_ops<KeyType>
+            ));
+            if constexpr (QPreferences::is_packed_bool<KeyType>) {
+                QPreferences::claim_pack_bit<KeyType>();
+            }
+        }
+        return key_id<KeyType>;
+    }
+
+    /**
+     * @brief Hand the overflow slot to a key type, resetting it if another key used it last.
+     *
+     * Every key past the capacity (or missing from the PrefRegistry) shares
+     * the one overflow slot, so its status bits are only valid for the key
+     * that set them. The slot's metadata records that owner. When the owner
+     * changes, the bits are cleared and the next access reloads from NVS.
+     * Unsaved RAM changes of the previous owner are lost.
+     *
+     * @tparam KeyType The PrefKey type
+     * @param key The key instance (copied on first use; supplies the default value)
+     */
+    template<typename KeyType>
+    void claim_overflow_slot(const KeyType& key) {
+        const KeyType* copy = stored_key(key);
+        std::lock_guard<QPreferences::SpinLock> guard(QPreferences::registry_lock);
+        size_t id = QPreferences::key_capacity;
+        auto& meta = QPreferences::key_metadata[id];
+        if (meta.ops != &QPreferences::key_ops<KeyType>) {
+            meta = {KeyType::namespace_name, KeyType::key_name, copy, &QPreferences::key_ops<KeyType>,
+                    QPreferences::UNTRACKED_NAMESPACE};
+            QPreferences::atomic_write(QPreferences::cache_entries[id].flags, uint8_t{0});
+        }
+    }
+
+    /**
+     * @brief Get unique cache ID for a preference key type.
+     *
+     * Each unique KeyType gets a single, persistent ID throughout program
+     * lifetime. Keys that were not constructed at runtime (constexpr keys)
+     * register here lazily on first access.
+     *
+     * With QPREFERENCES_EAGER_REGISTRATION (or QPREFERENCES_USE_REGISTRY)
+     * defined, the lazy path is compiled out of the accessors entirely: every
+     * key must be a runtime-constructed global or listed in the PrefRegistry
+     * (checked by assert in debug builds). Keys that get no slot of their
+     * own share the overflow slot (see claim_overflow_slot()).
+     *
+     * @tparam KeyType The PrefKey type
+     * @param key The key instance
+     * @return Unique ID for this key (index into cache_entries array)
+     */
+    template<typename KeyType>
+    size_t get_key_id(const KeyType& key) {
+        size_t id = QPreferences::atomic_read(key_id<KeyType>);
+#if defined(QPREFERENCES_EAGER_REGISTRATION) || defined(QPREFERENCES_USE_REGISTRY)
+        assert(id != QPreferences::UNREGISTERED_KEY && "QPreferences: key not registered (global PrefKey or PrefRegistry entry required)");
+        if (id == QPreferences::UNREGISTERED_KEY) {
+            // Release builds: use the overflow slot (RAM only for save()) rather than index out of bounds
+            id = QPreferences::key_capacity;
+        }
+#else
+        if (id == QPreferences::UNREGISTERED_KEY) {
+            id = register_key_type(key);
+        }
+#endif
+        if (id >= QPreferences::key_capacity) {
+            claim_overflow_slot(key);
+        }
+        return id;
+    }
+} // namespace detail
+
+} // namespace QPrefs
+
+#endif // QPREFERENCES_KEYOPS_H
@@ -0,0 +1,146 @@
+#ifndef QPREFERENCES_PACKEDBOOLS_H
+#define QPREFERENCES_PACKEDBOOLS_H
+
+#include <Preferences.h>
+#include <cassert>
+#include <cstdint>
+#include "CacheEntry.h"
+#include "StringLiteral.h"
+
+namespace QPreferences {
+
+/**
+ * @brief Hidden NVS key holding the packed bool keys of a namespace.
+ *
+ * Reserved: don't use it as a key name in a namespace with packed bools.
+ */
+static constexpr const char* PACKED_BOOLS_KEY = "_qp_bools";
+
+/// Highest bit index available to PrefOptions::pack_bit
+static constexpr int8_t MAX_PACK_BIT = 63;
+
+/**
+ * @brief Stored form of a namespace's packed bools (one 16-byte blob).
+ */
+struct PackedBools {
+    uint64_t values = 0;   ///< Bit n: value of the key with pack_bit n
+    uint64_t present = 0;  ///< Bit n: key with pack_bit n is saved (else it reads its default)
+};
+
+/**
+ * @brief RAM image of a namespace's packed bools, mirroring NVS.
+ *
+ * Read once when the first packed key of the namespace loads, updated by
+ * persist_entry() and written back once per save by flush_packed_bools().
+ * Only used under nvs_mutex.
+ */
+struct PackedBoolsState {
+    PackedBools bits;
+    bool loaded = false;   ///< bits reflects NVS
+    bool pending = false;  ///< bits changed since the last flush
+    uint64_t claimed = 0;  ///< Bit n: pack_bit n belongs to a registered key (under registry_lock)
+};
+
+/**
+ * @brief Packed-bool image of one namespace, instantiated only for namespaces with packed keys.
+ */
+template<auto Namespace>
+inline PackedBoolsState packed_bools;
+
+/**
+ * @brief Whether a key type is stored as a bit of its namespace's packed entry.
+ */
+template<typename KeyType>
+inline constexpr bool is_packed_bool = KeyType::options.pack_bit >= 0;
+
+/**
+ * @brief The packed-bool image of a key type's namespace.
+ */
+template<typename KeyType>
+PackedBoolsState& packed_state() {
+    return packed_bools<KeyType::namespace_literal>;
+}
+
+/**
+ * @brief Set when another key of the namespace registered the same pack_bit first.
+ *
+ * Such a key stays in RAM only: it reads its default and is never
+ * persisted, so it can't overwrite the other key's bit.
+ */
+template<typename KeyType>
+inline bool pack_bit_clash = false;
+
+/**
+ * @brief Reserve a key's pack_bit in its namespace at registration.
+ *
+ * Asserts in debug builds if the bit is already taken (PrefRegistry checks
+ * its key list at compile time); release builds flag the key with
+ * pack_bit_clash. Caller holds registry_lock.
+ *
+ * @tparam KeyType The packed PrefKey type
+ */
+template<typename KeyType>
+void claim_pack_bit() {
+    constexpr uint64_t bit = uint64_t{1} << KeyType::options.pack_bit;
+    auto& state = packed_state<KeyType>();
+    assert((state.claimed & bit) == 0 && "QPreferences: pack_bit already used by another key of this namespace");
+    pack_bit_clash<KeyType> = (state.claimed & bit) != 0;
+    state.claimed |= bit;
+}
+
+/**
+ * @brief Make sure a namespace's packed image is loaded. Caller holds nvs_mutex.
+ *
+ * @param state The namespace's image
+ * @param prefs Open read-only namespace handle, or nullptr if the namespace
+ *              doesn't exist (the image is reset to empty, e.g. by factoryReset())
+ */
+inline void load_packed_bools(PackedBoolsState& state, Preferences* prefs) {
+    if (prefs == nullptr) {
+        state.bits = {};
+        state.pending = false;
+        state.loaded = true;
+        return;
+    }
+    if (state.loaded) {
+        return;
+    }
+
+    state.bits = {};
+    if (prefs->isKey(PACKED_BOOLS_KEY) &&
+        prefs->getBytesLength(PACKED_BOOLS_KEY) == sizeof(PackedBools)) {
+        prefs->getBytes(PACKED_BOOLS_KEY, &state.bits, sizeof(PackedBools));
+    }
+    state.loaded = true;
+}
+
+/**
+ * @brief Write a namespace's packed image if any of its keys changed.
+ *
+ * One blob write covers every packed key persisted since the last flush;
+ * the entry is removed once no packed key is saved. The write budget and
+ * write count were charged once, by the first of those keys (see
+ * persist_entry()). Caller holds nvs_mutex.
+ *
+ * @tparam KeyType Any packed key type of the namespace
+ * @param prefs Namespace handle opened read-write
+ * @param report Receives bytes_written
+ */
+template<typename KeyType>
+void flush_packed_bools(Preferences& prefs, SaveReport& report) {
+    auto& state = packed_state<KeyType>();
+    if (!state.pending) {
+        return;
+    }
+    state.pending = false;
+
+    if (state.bits.present == 0) {
+        prefs.remove(PACKED_BOOLS_KEY);
+    } else {
+        report.bytes_written += prefs.putBytes(PACKED_BOOLS_KEY, &state.bits, sizeof(PackedBools));
+    }
+}
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_PACKEDBOOLS_H
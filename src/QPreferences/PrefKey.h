@@ -1,7 +1,10 @@
 #ifndef QPREFERENCES_PREFKEY_H
 #define QPREFERENCES_PREFKEY_H
 
+#include <type_traits>
 #include "StringLiteral.h"
+#include "PrefOptions.h"
+#include "KeyOps.h"
 
 namespace QPreferences {
 
@@ -15,21 +18,39 @@ namespace QPreferences {
  * @tparam T The value type (int, float, bool, String, etc.)
  * @tparam Namespace The namespace name (max 15 characters)
  * @tparam Key The key name (max 15 characters)
+ * @tparam Options Per-key compile-time options (see PrefOptions)
  *
  * ESP32 Preferences limits:
  *   - Namespace: 15 characters max
  *   - Key name: 15 characters max
  *
+ * Keys self-register on construction, so global PrefKey definitions are
+ * visible to preload() and forEach() before their first access. The library
+ * keeps its own copy of the first instance, which supplies the default
+ * value for type-erased operations, so a key may also be a local or a
+ * temporary. With QPREFERENCES_USE_REGISTRY, keys are registered by a
+ * PrefRegistry instead (see Registry.h).
+ *
  * Usage:
  *   PrefKey<int, "myapp", "counter"> counterKey{0};
  *   PrefKey<float, "myapp", "threshold"> thresholdKey{1.5f};
  *   PrefKey<bool, "myapp", "enabled"> enabledKey{true};
+ *   PrefKey<String, "myapp", "cert", PrefOptions{.baseline = Baseline::Hash}> certKey{""};
  */
-template<typename T, StringLiteral Namespace, StringLiteral Key>
+template<typename T, StringLiteral Namespace, StringLiteral Key, PrefOptions Options = PrefOptions{}>
 struct PrefKey {
     // Compile-time validation of namespace and key lengths
     static_assert(Namespace.size() <= 15, "Namespace must be 15 characters or less");
     static_assert(Key.size() <= 15, "Key name must be 15 characters or less");
+    static_assert(Options.baseline != Baseline::Hash || std::is_same_v<T, String>,
+                  "Baseline::Hash is only supported for String keys");
+    static_assert((Options.abs_epsilon == 0.0f && Options.rel_epsilon == 0.0f) ||
+                  (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>),
+                  "abs_epsilon/rel_epsilon are only supported for numeric keys");
+    static_assert(Options.abs_epsilon >= 0.0f && Options.rel_epsilon >= 0.0f,
+                  "abs_epsilon/rel_epsilon must not be negative");
+    static_assert(Options.pack_bit < 0 || std::is_same_v<T, bool>, "pack_bit is only supported for bool keys");
+    static_assert(Options.pack_bit <= MAX_PACK_BIT, "pack_bit must be between 0 and 63");
 
     /// The value type for this preference
     using value_type = T;
@@ -37,9 +58,18 @@ struct PrefKey {
     /// The namespace name as a C-string
     static constexpr const char* namespace_name = Namespace.value;
 
+    /// The namespace name as a template argument (selects the packed-bool image)
+    static constexpr auto namespace_literal = Namespace;
+
+    /// Compile-time hash of the namespace name (used for namespace interning)
+    static constexpr uint32_t namespace_hash = Namespace.hash();
+
     /// The key name as a C-string
     static constexpr const char* key_name = Key.value;
 
+    /// Per-key compile-time options
+    static constexpr PrefOptions options = Options;
+
     /// The default value for this preference
     T default_value;
 
@@ -47,7 +77,15 @@ struct PrefKey {
      * @brief Construct a PrefKey with the given default value.
      * @param default_val The default value to use when preference is not set
      */
-    constexpr explicit PrefKey(T default_val) : default_value(default_val) {}
+    constexpr explicit PrefKey(T default_val) : default_value(default_val) {
+#ifndef QPREFERENCES_USE_REGISTRY
+        // Self-register at runtime construction (skipped for constexpr keys,
+        // which register lazily on first access instead)
+        if (!std::is_constant_evaluated()) {
+            QPrefs::detail::register_key_type(*this);
+        }
+#endif
+    }
 };
 
 } // namespace QPreferences
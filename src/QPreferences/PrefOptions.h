@@ -0,0 +1,57 @@
+#ifndef QPREFERENCES_PREFOPTIONS_H
+#define QPREFERENCES_PREFOPTIONS_H
+
+#include <cstdint>
+
+namespace QPreferences {
+
+/**
+ * @brief How a key remembers its last-known NVS value for dirty detection.
+ */
+enum class Baseline : uint8_t {
+    /// Keep a full copy of the NVS value (exact comparison)
+    Copy,
+
+    /// Keep only length + 32-bit FNV-1a hash (String keys only).
+    /// Saves a second heap copy; a change whose hash collides with the
+    /// baseline (probability ~2^-32) is not detected as dirty.
+    Hash
+};
+
+/**
+ * @brief Per-key compile-time options, passed as PrefKey's fourth template argument.
+ *
+ * A structural aggregate so it can be used as a non-type template parameter
+ * with designated initializers; omitted fields keep their defaults.
+ *
+ * Usage:
+ *   PrefKey<String, "net", "cert", PrefOptions{.baseline = Baseline::Hash}> certKey{""};
+ *   PrefKey<int, "ui", "volume", PrefOptions{.min_interval_ms = 10000}> volumeKey{50};
+ *   PrefKey<float, "cal", "gain", PrefOptions{.rel_epsilon = 1e-4f}> gainKey{1.0f};
+ *   PrefKey<bool, "flags", "beta", PrefOptions{.pack_bit = 0}> betaKey{false};
+ */
+struct PrefOptions {
+    /// Baseline storage for dirty detection (see Baseline)
+    Baseline baseline = Baseline::Copy;
+
+    /// Minimum time between two NVS writes of this key; saves in between are
+    /// deferred and the key stays dirty (0 = no limit)
+    uint32_t min_interval_ms = 0;
+
+    /// Dead-band for numeric keys: a change of at most this much from the
+    /// stored value doesn't make the key dirty (0 = exact comparison)
+    float abs_epsilon = 0.0f;
+
+    /// Dead-band relative to the larger magnitude of the two values;
+    /// a change within either epsilon is insignificant (0 = off)
+    float rel_epsilon = 0.0f;
+
+    /// Bool keys only: store the key as bit pack_bit (0-63) of one hidden
+    /// entry shared by the namespace's packed bools (-1 = own NVS entry).
+    /// Bits must be unique per namespace and stable across firmware versions
+    int8_t pack_bit = -1;
+};
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_PREFOPTIONS_H
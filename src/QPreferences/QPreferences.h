@@ -1,33 +1,101 @@
 #ifndef QPREFERENCES_QPREFERENCES_H
 #define QPREFERENCES_QPREFERENCES_H
 
+#include <Arduino.h>
 #include <Preferences.h>
 #include <type_traits>
-#include <variant>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include "PrefKey.h"
 #include "CacheEntry.h"
+#include "KeyOps.h"
+#include "Registry.h"
 
 namespace QPrefs {
 
 namespace detail {
     /**
-     * @brief Get unique cache ID for a preference key type.
+     * @brief Get a key's cache entry, loading it from NVS on first access.
      *
-     * Uses static variable initialization to ensure each unique KeyType
-     * gets a single, persistent ID throughout program lifetime.
-     * Also registers the namespace and key name for runtime access by save().
+     * @tparam KeyType The PrefKey type
+     * @param key The preference key definition
+     * @param id The key's cache ID (from get_key_id)
+     * @return The initialized cache entry
+     */
+    template<typename KeyType>
+    QPreferences::CacheEntry& loaded_entry(const KeyType& key, size_t id) {
+        auto& entry = QPreferences::cache_entries[id];
+
+        // Lazy initialization: load from NVS only on first access
+        if (!entry.is_initialized()) {
+            std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+
+            // Another task may have loaded it while we waited
+            if (!entry.is_initialized()) {
+                Preferences prefs;
+                // Read-only open; skipped if the namespace is already known to be missing
+                if (QPreferences::begin_read(prefs, KeyType::namespace_name,
+                                             QPreferences::key_metadata[id].namespace_index)) {
+                    QPreferences::load_entry<KeyType>(&prefs, entry, &key);
+                    prefs.end();
+                } else {
+                    // Namespace doesn't exist (fresh device) - use default value
+                    QPreferences::load_entry<KeyType>(nullptr, entry, &key);
+                }
+            }
+        }
+
+        return entry;
+    }
+
+    /**
+     * @brief Recompute a key's dirty flag after its cached value changed.
+     *
+     * Smart dirty comparison: against the NVS baseline if NVS has a value,
+     * otherwise against the default (so a default on a fresh device is clean),
+     * within the key's dead-band (PrefOptions abs_epsilon/rel_epsilon).
+     * A key whose NVS value couldn't be read back stays dirty until saved.
+     * Caller holds the key's SlotAccess lock.
      *
      * @tparam KeyType The PrefKey type
-     * @return Unique ID for this key (index into cache_entries array)
+     * @param key The preference key definition
+     * @param id The key's cache ID
+     * @param entry The key's (initialized) cache entry
      */
     template<typename KeyType>
-    size_t get_key_id() {
-        static size_t id = QPreferences::register_key(
-            KeyType::namespace_name,
-            KeyType::key_name
-        );
-        return id;
+    void refresh_dirty(const KeyType& key, size_t id, const QPreferences::CacheEntry& entry) {
+        using Slot = QPreferences::SlotAccess<KeyType>;
+        if (entry.is_stale()) {
+            QPreferences::mark_dirty(id, true);  // Stale NVS value must be rewritten or removed
+        } else if (entry.has_nvs_value()) {
+            QPreferences::mark_dirty(id, Slot::differs_from_baseline(entry, Slot::value(entry)));
+        } else {
+            QPreferences::mark_dirty(id, QPreferences::differs<KeyType>(Slot::value(entry), key.default_value));
+        }
+    }
+
+    /**
+     * @brief Whether one element of an array key differs from the value it is saved as.
+     *
+     * Compares against the NVS baseline if NVS has a value, otherwise against
+     * the default; an element present on only one side differs. Caller holds
+     * the key's SlotAccess lock.
+     *
+     * @tparam KeyType A PrefKey of std::array or FixedVector
+     */
+    template<typename KeyType>
+    bool element_differs(const KeyType& key, const QPreferences::CacheEntry& entry, size_t index) {
+        const auto& value = QPreferences::value_slot<KeyType>.value;
+        const auto& reference = entry.has_nvs_value() ? QPreferences::value_slot<KeyType>.baseline
+                                                      : key.default_value;
+        bool in_value = index < value.size();
+        bool in_reference = index < reference.size();
+        if (!in_value || !in_reference) {
+            return in_value != in_reference;
+        }
+        return !QPreferences::values_equal(value[index], reference[index]);
     }
 } // namespace detail
 
@@ -36,6 +104,7 @@ namespace detail {
  *
  * First access: Reads from NVS and caches in RAM.
  * Subsequent access: Returns cached value without NVS access.
+ * Returns a copy; use view(key) to read String values without allocating.
  *
  * @tparam KeyType The PrefKey type (automatically deduced)
  * @param key The preference key definition
@@ -47,68 +116,164 @@ namespace detail {
  */
 template<typename KeyType>
 typename KeyType::value_type get(const KeyType& key) {
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
+
+    [[maybe_unused]] auto guard = Slot::read_lock(entry);  // No lock for scalars
+    return Slot::value(entry);
+}
+
+/**
+ * @brief Read a preference without copying it.
+ *
+ * Same lazy loading as get(), but returns a const reference into the cache
+ * (scalar and bool keys return by value). The reference stays valid until
+ * the key is next modified by set(), reset() or factoryReset().
+ *
+ * With QPREFERENCES_THREAD_SAFE another task could modify the value while
+ * the reference is in use, so view() returns a copy there, like get().
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced)
+ * @param key The preference key definition
+ * @return const reference to the cached value
+ *
+ * Usage:
+ *   PrefKey<String, "mqtt", "topic"> topicKey{String("dev/state")};
+ *   client.publish(QPrefs::view(topicKey).c_str(), payload);  // No String copy
+ */
+template<typename KeyType>
+decltype(auto) view(const KeyType& key) {
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    if constexpr (QPreferences::thread_safe && !Slot::lock_free) {
+        return get(key);
+    } else {
+        auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
+        return Slot::value(entry);
+    }
+}
+
+/**
+ * @brief Read a scalar preference from an interrupt handler.
+ *
+ * Returns the cached value with a fixed handful of loads: no NVS access,
+ * no lazy loading, no locks and no heap, so it is safe in ISRs (placed in
+ * IRAM on ESP32). Word-sized values are read with a single atomic load, so
+ * the result is never torn, even while another core runs set().
+ *
+ * The key must already be loaded (get(), preload() or preloadAll() in
+ * setup()). Reading a key that isn't loaded returns its default value (no
+ * assert: the assert handler lives in flash).
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced; int, float or bool value)
+ * @param key The preference key definition (a non-constexpr global, so it lives in RAM)
+ * @return The cached value
+ *
+ * Usage:
+ *   PrefKey<int, "cal", "threshold"> threshold{512};
+ *   void IRAM_ATTR onTimer() {
+ *       if (analogValue > QPrefs::getFromISR(threshold)) { ... }
+ *   }
+ */
+template<typename KeyType>
+QPREFERENCES_ISR_ATTR typename KeyType::value_type getFromISR(const KeyType& key) {
     using T = typename KeyType::value_type;
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
+    static_assert(QPreferences::is_lock_free_value<T>,
+                  "getFromISR() supports word-sized scalar keys only (int, float, bool)");
 
-    // Lazy initialization: load from NVS only on first access
-    if (!entry.is_initialized()) {
-        Preferences prefs;
-        // true = read-only mode (doesn't create namespace if missing)
-        bool opened = prefs.begin(KeyType::namespace_name, true);
-
-        if (!opened) {
-            // Namespace doesn't exist (fresh device) - use default value
-            entry.value = key.default_value;
-            // Leave entry.nvs_value empty (no NVS value exists)
-            entry.initialized = true;
-            entry.dirty = false;
-        } else {
-            // Namespace exists - check if key exists before reading
-            if (prefs.isKey(KeyType::key_name)) {
-                // Key exists in NVS - read it
-                T nvs_result;
-
-                if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
-                    nvs_result = prefs.getInt(KeyType::key_name, key.default_value);
-                } else if constexpr (std::is_same_v<T, float>) {
-                    nvs_result = prefs.getFloat(KeyType::key_name, key.default_value);
-                } else if constexpr (std::is_same_v<T, bool>) {
-                    nvs_result = prefs.getBool(KeyType::key_name, key.default_value);
-                } else if constexpr (std::is_same_v<T, String>) {
-                    nvs_result = prefs.getString(KeyType::key_name, key.default_value);
-                } else {
-                    static_assert(sizeof(T) == 0, "Unsupported type for QPreferences: supported types are int, float, bool, String");
-                }
+    // Builtins rather than helpers: nothing here may call out of IRAM
+    size_t id = __atomic_load_n(&detail::key_id<KeyType>, __ATOMIC_ACQUIRE);
+    uint8_t flags = id >= QPreferences::key_capacity  // Unregistered, or the shared overflow slot
+        ? 0
+        : __atomic_load_n(&QPreferences::cache_entries[id].flags, __ATOMIC_ACQUIRE);
 
-                entry.value = nvs_result;
-                entry.nvs_value = nvs_result;  // Key exists in NVS
-            } else {
-                // Key doesn't exist in this namespace - use default
-                entry.value = key.default_value;
-                // Leave nvs_value empty - nothing in NVS for this key
-            }
+    if (!(flags & QPreferences::CacheEntry::INITIALIZED)) {
+        return key.default_value;  // Not loaded: preload it in setup()
+    }
 
-            prefs.end();
-            entry.initialized = true;
-            entry.dirty = false;
+    if constexpr (std::is_same_v<T, bool>) {
+        return (flags & QPreferences::CacheEntry::BOOL_VALUE) != 0;
+    } else {
+        T value;
+        __atomic_load(&QPreferences::value_slot<KeyType>.value, &value, __ATOMIC_RELAXED);
+        return value;
+    }
+}
+
+/**
+ * @brief Load all registered keys of a namespace with a single NVS open.
+ *
+ * Opens the namespace read-only once and fills every uninitialized cache
+ * entry that belongs to it, instead of one begin/end cycle per key on
+ * first get(). Entries that are already loaded are left untouched, so
+ * unsaved RAM changes are never overwritten.
+ *
+ * @param ns The namespace to preload
+ *
+ * Usage:
+ *   QPrefs::preload("wifi");  // One NVS open for all wifi keys
+ */
+inline void preload(const char* ns) {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    Preferences prefs;
+    bool attempted = false;
+    bool opened = false;
+    size_t ns_index = QPreferences::find_namespace(ns);
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+
+    for (size_t i = 0; i < count; ++i) {
+        auto& entry = QPreferences::cache_entries[i];
+        auto& meta = QPreferences::key_metadata[i];
+
+        if (entry.is_initialized() || !QPreferences::in_namespace(meta, ns_index, ns)) {
+            continue;
         }
+
+        // Open lazily so fully-loaded namespaces cost nothing
+        if (!attempted) {
+            opened = QPreferences::begin_read(prefs, ns, meta.namespace_index);
+            attempted = true;
+        }
+
+        // nullptr = namespace missing (fresh device), entries get defaults
+        meta.ops->load(opened ? &prefs : nullptr, entry, meta.key);
+    }
+
+    if (opened) {
+        prefs.end();
     }
+}
 
-    // Return cached value
-    return std::get<T>(entry.value);
+/**
+ * @brief Load all registered keys, opening each namespace once.
+ *
+ * Call early in setup() so later get() calls are served from RAM.
+ * Keys self-register on construction, so all global PrefKey definitions
+ * are covered.
+ */
+inline void preloadAll() {
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+    for (size_t i = 0; i < count; ++i) {
+        if (!QPreferences::cache_entries[i].is_initialized()) {
+            preload(QPreferences::key_metadata[i].namespace_name);
+        }
+    }
 }
 
 /**
  * @brief Set a preference value in RAM cache only (no NVS write).
  *
  * Updates the cached value in RAM and computes dirty flag intelligently:
- * - If NVS has a value: dirty = (value != nvs_value)
+ * - If NVS has a value: dirty = (value != NVS baseline)
  * - If NVS has no value: dirty = (value != default_value)
+ * Keys with a dead-band (abs_epsilon/rel_epsilon) ignore changes within it.
  *
  * This means set(key, default) on fresh device marks dirty=false (nothing to save).
  * Does NOT write to NVS flash - use save() to persist changes.
  * The value type must match the key's value_type at compile time.
  *
+ * Rvalues are moved into the cache, so set(key, std::move(str)) or
+ * set(key, String(...)) doesn't allocate a second copy.
+ *
  * @tparam KeyType The PrefKey type (automatically deduced)
  * @param key The preference key definition
  * @param value The value to store (must match KeyType::value_type)
@@ -120,29 +285,175 @@ typename KeyType::value_type get(const KeyType& key) {
  *   // QPrefs::set(countKey, 3.14); // Compile error: float doesn't match int
  */
 template<typename KeyType>
-bool set(const KeyType& key, typename KeyType::value_type value) {
+bool set(const KeyType& key, typename KeyType::value_type&& value) {
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    size_t id = detail::get_key_id(key);
+
+    // Ensure cache is initialized (loads NVS baseline for smart dirty comparison)
+    auto& entry = detail::loaded_entry(key, id);
+
+    // Store value in RAM cache only (moved, no copy)
+    auto guard = Slot::lock(entry);
+    Slot::set_value(entry, std::move(value));
+    detail::refresh_dirty(key, id, entry);
+
+    return true;  // RAM write always succeeds
+}
+
+/**
+ * @brief Set a preference value from an lvalue (copies once into the cache).
+ *
+ * See set(key, T&&) for semantics.
+ */
+template<typename KeyType>
+bool set(const KeyType& key, const typename KeyType::value_type& value) {
+    return set(key, typename KeyType::value_type(value));
+}
+
+/**
+ * @brief Set one element of a std::array or FixedVector preference in RAM.
+ *
+ * Only the written element is compared: writing an unchanged element is a
+ * no-op, and a changed element that differs from its saved value marks the
+ * key dirty without comparing the rest. The whole array is still saved as
+ * one blob by save().
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced)
+ * @param key The preference key definition
+ * @param index Element index (must be below the current size)
+ * @param value The element value
+ * @return false if index is out of range (nothing changed)
+ *
+ * Usage:
+ *   PrefKey<std::array<float, 16>, "audio", "gains"> gainsKey{{}};
+ *   QPrefs::set(gainsKey, 3, 0.8f);
+ */
+template<typename KeyType>
+bool set(const KeyType& key, size_t index, const typename KeyType::value_type::value_type& value) {
     using T = typename KeyType::value_type;
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    static_assert(QPreferences::is_element_container<T>,
+                  "set(key, index, value) requires a std::array or FixedVector preference");
+    size_t id = detail::get_key_id(key);
+    auto& entry = detail::loaded_entry(key, id);
 
-    // Ensure cache is initialized (loads nvs_value for smart dirty comparison)
-    if (!entry.is_initialized()) {
-        // Lazy load from NVS to populate nvs_value
-        get(key);
+    auto guard = Slot::lock(entry);
+    auto& current = QPreferences::value_slot<KeyType>.value;
+    if (index >= current.size()) {
+        return false;
+    }
+    if (QPreferences::values_equal(current[index], value)) {
+        return true;  // Unchanged: dirty flag is still accurate
     }
 
-    // Store value in RAM cache only
-    entry.value = value;
+    current[index] = value;
+    if (detail::element_differs(key, entry, index)) {
+        QPreferences::mark_dirty(id, true);  // This element alone makes the key dirty
+    } else {
+        detail::refresh_dirty(key, id, entry);  // Reverted: other elements may still differ
+    }
+    return true;
+}
 
-    // Smart dirty comparison: compare against NVS value if exists, else default
-    if (entry.nvs_value.has_value()) {
-        entry.dirty = (value != std::get<T>(entry.nvs_value.value()));
+/**
+ * @brief Modify a preference value in place in the RAM cache.
+ *
+ * Calls fn with a mutable reference to the cached value, then recomputes
+ * the dirty flag once. Avoids the copy and double lookup of get() + set().
+ * Does NOT write to NVS flash - use save() to persist changes.
+ *
+ * With QPREFERENCES_THREAD_SAFE, fn runs outside any lock for scalar and
+ * bool keys and is retried if another task changed the value meanwhile, so
+ * it may be called more than once. For other types fn runs under the key's
+ * mutex and must not access the same key.
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced)
+ * @tparam Fn Callable accepting (T&)
+ * @param key The preference key definition
+ * @param fn Function that modifies the value
+ * @return true (update always succeeds in RAM)
+ *
+ * Usage:
+ *   PrefKey<String, "myapp", "log"> logKey{String("")};
+ *   QPrefs::update(logKey, [](String& s) { s += "boot;"; });
+ */
+template<typename KeyType, typename Fn>
+bool update(const KeyType& key, Fn&& fn) {
+    using T = typename KeyType::value_type;
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    size_t id = detail::get_key_id(key);
+    auto& entry = detail::loaded_entry(key, id);
+
+    if constexpr (QPreferences::thread_safe && Slot::lock_free) {
+        // Optimistic: compute outside the spinlock, commit if nothing changed
+        for (;;) {
+            T before = Slot::value(entry);
+            T after = before;
+            fn(after);
+
+            auto guard = Slot::lock(entry);
+            T current = Slot::value(entry);
+            if (std::memcmp(&current, &before, sizeof(T)) == 0) {
+                Slot::set_value(entry, after);
+                detail::refresh_dirty(key, id, entry);
+                break;
+            }
+        }
     } else {
-        entry.dirty = (value != key.default_value);
+        auto guard = Slot::lock(entry);
+        Slot::modify(entry, fn);
+        detail::refresh_dirty(key, id, entry);
     }
 
     return true;  // RAM write always succeeds
 }
 
+/**
+ * @brief Add delta to a numeric preference in place.
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced; int or float value)
+ * @param key The preference key definition
+ * @param delta Amount to add (default 1)
+ * @return The new value
+ *
+ * Usage:
+ *   PrefKey<int, "stats", "boots"> bootCount{0};
+ *   QPrefs::increment(bootCount);
+ */
+template<typename KeyType>
+typename KeyType::value_type increment(const KeyType& key, typename KeyType::value_type delta = 1) {
+    using T = typename KeyType::value_type;
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "increment() requires a numeric preference");
+
+    T result{};
+    update(key, [&](T& v) {
+        v += delta;
+        result = v;
+    });
+    return result;
+}
+
+/**
+ * @brief Invert a bool preference in place.
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced; bool value)
+ * @param key The preference key definition
+ * @return The new value
+ */
+template<typename KeyType>
+bool toggle(const KeyType& key) {
+    static_assert(std::is_same_v<typename KeyType::value_type, bool>,
+                  "toggle() requires a bool preference");
+
+    bool result = false;
+    update(key, [&](bool& v) {
+        v = !v;
+        result = v;
+    });
+    return result;
+}
+
 /**
  * @brief Check if a preference value differs from its default.
  *
@@ -162,16 +473,13 @@ bool set(const KeyType& key, typename KeyType::value_type value) {
  */
 template<typename KeyType>
 bool isModified(const KeyType& key) {
-    using T = typename KeyType::value_type;
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
+    using Slot = QPreferences::SlotAccess<KeyType>;
 
     // Ensure cache is initialized
-    if (!entry.is_initialized()) {
-        get(key);  // Triggers lazy load
-    }
+    auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
 
-    T current = std::get<T>(entry.value);
-    return current != key.default_value;
+    [[maybe_unused]] auto guard = Slot::read_lock(entry);
+    return !QPreferences::values_equal(Slot::value(entry), key.default_value);
 }
 
 /**
@@ -193,16 +501,41 @@ bool isModified(const KeyType& key) {
  */
 template<typename KeyType>
 bool isDirty(const KeyType& key) {
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
-
     // Ensure cache is initialized
-    if (!entry.is_initialized()) {
-        get(key);  // Triggers lazy load
-    }
+    auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
 
     return entry.is_dirty();
 }
 
+/**
+ * @brief Check if one element of a std::array or FixedVector preference has unsaved changes.
+ *
+ * A key whose stored blob couldn't be read back (its size changed) reports
+ * every element dirty, matching isDirty(key): the whole blob is rewritten
+ * or removed by the next save.
+ *
+ * @tparam KeyType The PrefKey type (automatically deduced)
+ * @param key The preference key definition
+ * @param index Element index
+ * @return true if the element differs from NVS (or exists on only one side)
+ *
+ * Usage:
+ *   if (QPrefs::isDirty(gainsKey, 3)) { ... }
+ */
+template<typename KeyType>
+bool isDirty(const KeyType& key, size_t index) {
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    static_assert(QPreferences::is_element_container<typename KeyType::value_type>,
+                  "isDirty(key, index) requires a std::array or FixedVector preference");
+    auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
+
+    auto guard = Slot::read_lock(entry);
+    if (entry.is_stale()) {
+        return true;  // Whole blob pending rewrite
+    }
+    return entry.is_dirty() && detail::element_differs(key, entry, index);
+}
+
 /**
  * @brief Check if a preference value exists in NVS.
  *
@@ -224,14 +557,10 @@ bool isDirty(const KeyType& key) {
  */
 template<typename KeyType>
 bool isSaved(const KeyType& key) {
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
-
     // Ensure cache is initialized
-    if (!entry.is_initialized()) {
-        get(key);  // Triggers lazy load
-    }
+    auto& entry = detail::loaded_entry(key, detail::get_key_id(key));
 
-    return entry.nvs_value.has_value();
+    return entry.has_nvs_value();
 }
 
 /**
@@ -258,23 +587,16 @@ bool isSaved(const KeyType& key) {
  */
 template<typename KeyType>
 void reset(const KeyType& key) {
-    using T = typename KeyType::value_type;
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
+    size_t id = detail::get_key_id(key);
 
     // Ensure cache is initialized
-    if (!entry.is_initialized()) {
-        get(key);  // Triggers lazy load
-    }
-
-    // Set RAM value to default
-    entry.value = key.default_value;
+    auto& entry = detail::loaded_entry(key, id);
 
-    // Update dirty flag: dirty if NVS has a different value
-    if (entry.nvs_value.has_value()) {
-        entry.dirty = (key.default_value != std::get<T>(entry.nvs_value.value()));
-    } else {
-        entry.dirty = false;  // No NVS value, default matches "nothing"
-    }
+    // Set RAM value to default; dirty only if NVS has a different value
+    using Slot = QPreferences::SlotAccess<KeyType>;
+    auto guard = Slot::lock(entry);
+    Slot::set_value(entry, key.default_value);
+    detail::refresh_dirty(key, id, entry);
 }
 
 /**
@@ -282,109 +604,378 @@ void reset(const KeyType& key) {
  *
  * If the current value equals the default, removes the key from NVS (PERS-04).
  * If the current value differs from default, writes to NVS.
- * After save, isDirty(key) returns false.
+ * After save, isDirty(key) returns false. If the namespace can't be opened
+ * the key stays dirty and is reported as skipped.
  *
  * @tparam KeyType The PrefKey type (automatically deduced)
  * @param key The preference key to save
+ * @return What was written, removed or skipped
  */
 template<typename KeyType>
-void save(const KeyType& key) {
-    using T = typename KeyType::value_type;
-    auto& entry = QPreferences::cache_entries[detail::get_key_id<KeyType>()];
-    auto& meta = QPreferences::key_metadata[detail::get_key_id<KeyType>()];
+QPreferences::SaveReport save(const KeyType& key) {
+    size_t id = detail::get_key_id(key);
+    auto& entry = QPreferences::cache_entries[id];
+    auto& meta = QPreferences::key_metadata[id];
+    QPreferences::SaveReport report;
+    uint32_t start = micros();
 
     if (!entry.is_initialized() || !entry.is_dirty()) {
-        return;  // Nothing to save
+        report.skipped = 1;  // Nothing to save
+        report.elapsed_us = micros() - start;
+        return report;
     }
 
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
     Preferences prefs;
-    prefs.begin(meta.namespace_name, false);  // false = read-write
-
-    T current = std::get<T>(entry.value);
+    if (!QPreferences::begin_write(prefs, KeyType::namespace_name, meta.namespace_index)) {
+        report.skipped = 1;  // Stays dirty for a later attempt
+        report.elapsed_us = micros() - start;
+        return report;
+    }
+    report.namespaces_opened = 1;
 
-    if (current == key.default_value) {
-        // Remove from NVS if equals default (PERS-04)
-        prefs.remove(meta.key_name);
-        entry.nvs_value.reset();  // Mark as no NVS value
-    } else {
-        // Write to NVS
-        if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
-            prefs.putInt(meta.key_name, current);
-        } else if constexpr (std::is_same_v<T, float>) {
-            prefs.putFloat(meta.key_name, current);
-        } else if constexpr (std::is_same_v<T, bool>) {
-            prefs.putBool(meta.key_name, current);
-        } else if constexpr (std::is_same_v<T, String>) {
-            prefs.putString(meta.key_name, current);
-        }
-        entry.nvs_value = entry.value;
+    // Remove from NVS if equals default (PERS-04), otherwise write
+    QPreferences::persist_entry<KeyType>(prefs, entry, &key, report);
+    if constexpr (QPreferences::is_packed_bool<KeyType>) {
+        QPreferences::flush_packed_bools<KeyType>(prefs, report);
     }
 
     prefs.end();
-    entry.dirty = false;
+    report.elapsed_us = micros() - start;
+    return report;
 }
 
+namespace detail {
+    /**
+     * @brief Progress of saveStep() through one pass over the dirty keys.
+     *
+     * The namespace handle stays open between calls only while the open
+     * namespace has dirty keys left; a save() of dirty keys and
+     * factoryReset() close it and restart the pass.
+     * Namespaces beyond MAX_NAMESPACES have no visited flag: they are
+     * identified by their lowest key id and done in that order.
+     */
+    struct SaveStepState {
+        Preferences prefs;
+        bool open = false;      ///< prefs is open read-write
+        size_t ns_key = 0;      ///< First key of the open namespace (for same_namespace)
+        size_t next_id = 0;     ///< Resume point within the open namespace
+        size_t untracked_next = 0;  ///< Untracked namespaces below this lowest key id are done
+        void (*flush)(Preferences&, QPreferences::SaveReport&) = nullptr;  ///< Packed bools to write
+        std::array<bool, QPreferences::MAX_NAMESPACES> visited{};  ///< Namespaces done this pass
+    };
+
+    inline SaveStepState save_step_state;
+
+    /**
+     * @brief Lowest key id registered in the namespace of a key.
+     *
+     * Identifies an untracked namespace. Linear in id, but only used for
+     * namespaces beyond MAX_NAMESPACES.
+     */
+    inline size_t namespace_leader(size_t id) {
+        auto& meta = QPreferences::key_metadata[id];
+        for (size_t i = 0; i < id; ++i) {
+            if (QPreferences::same_namespace(QPreferences::key_metadata[i], meta)) {
+                return i;
+            }
+        }
+        return id;
+    }
+
+    /**
+     * @brief Mark the namespace of a key as handled for the rest of the pass.
+     */
+    inline void mark_save_step_visited(SaveStepState& state, size_t id) {
+        size_t ns_index = QPreferences::key_metadata[id].namespace_index;
+        if (ns_index != QPreferences::UNTRACKED_NAMESPACE) {
+            state.visited[ns_index] = true;
+        } else {
+            state.untracked_next = namespace_leader(id) + 1;
+        }
+    }
+
+    /**
+     * @brief First dirty key of the next namespace saveStep() has not visited.
+     *
+     * Interned namespaces come first, in key order; untracked ones follow in
+     * the order of their lowest key id, so untracked_next only moves forward.
+     *
+     * @return The key id, or UNREGISTERED_KEY when the pass is complete
+     */
+    inline size_t next_save_step_key(const SaveStepState& state) {
+        size_t id = QPreferences::find_dirty([&](size_t i) {
+            size_t ns_index = QPreferences::key_metadata[i].namespace_index;
+            return ns_index != QPreferences::UNTRACKED_NAMESPACE && !state.visited[ns_index];
+        });
+        if (id != QPreferences::UNREGISTERED_KEY) {
+            return id;
+        }
+        size_t best_leader = QPreferences::UNREGISTERED_KEY;
+        QPreferences::for_each_dirty([&](size_t i) {
+            if (QPreferences::key_metadata[i].namespace_index != QPreferences::UNTRACKED_NAMESPACE) {
+                return;
+            }
+            size_t leader = namespace_leader(i);
+            if (leader >= state.untracked_next && leader < best_leader) {
+                best_leader = leader;
+                id = i;  // Lowest dirty id of that namespace: visited in index order
+            }
+        });
+        return id;
+    }
+
+    /**
+     * @brief Write the packed bools persisted by saveStep() so far.
+     * @param report Receives the bytes written
+     */
+    inline void flush_save_step(SaveStepState& state, QPreferences::SaveReport& report) {
+        if (state.flush != nullptr) {
+            state.flush(state.prefs, report);
+            state.flush = nullptr;
+        }
+    }
+
+    /**
+     * @brief Finish the namespace saveStep() has open, if any, and close its handle.
+     * @param report Receives the bytes written by the packed bools flush
+     */
+    inline void end_save_step_namespace(SaveStepState& state, QPreferences::SaveReport& report) {
+        if (!state.open) {
+            return;
+        }
+        flush_save_step(state, report);
+        state.prefs.end();
+        state.open = false;
+        mark_save_step_visited(state, state.ns_key);
+    }
+
+    /**
+     * @brief End the current saveStep() pass: close its namespace and start over.
+     * @param report Receives the bytes written by the packed bools flush
+     */
+    inline void restart_save_step(SaveStepState& state, QPreferences::SaveReport& report) {
+        end_save_step_namespace(state, report);
+        state.visited = {};
+        state.untracked_next = 0;
+    }
+} // namespace detail
+
 /**
  * @brief Persist all dirty preference values to NVS flash in a single operation.
  *
- * Groups dirty entries by namespace and writes all entries in the same namespace
- * within a single begin/end cycle to minimize flash wear (PERS-05).
+ * Groups dirty entries by namespace so each namespace gets exactly one
+ * begin/end cycle per call, even when keys of different namespaces are
+ * interleaved in registration order (PERS-05).
+ * Only dirty slots are visited (via the dirty bitmap), and the call returns
+ * immediately when nothing is dirty, so it is cheap to call periodically.
  *
- * Note: Unlike save(key), this function does NOT perform default value comparison
- * because it operates without template context. Values are always written.
- * Use save(key) for individual keys if you want default removal behavior.
+ * Like save(key), keys whose value equals their default are removed from
+ * NVS instead of written (through the type-erased KeyOps::persist).
  *
  * After save() completes, isDirty() returns false for all saved keys.
+ * Keys of a namespace that fails to open stay dirty and are reported as
+ * skipped.
+ *
+ * @return Keys written/skipped, namespaces opened, bytes and elapsed time
  */
-inline void save() {
+inline QPreferences::SaveReport save() {
+    QPreferences::SaveReport report;
+    if (QPreferences::atomic_read(QPreferences::dirty_count) == 0) {
+        return report;  // Nothing to save
+    }
+
+    uint32_t start = micros();
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    detail::restart_save_step(detail::save_step_state, report);  // Its keys are saved below
     Preferences prefs;
-    const char* current_namespace = nullptr;
+    std::array<bool, QPreferences::MAX_NAMESPACES> handled{};
 
-    for (size_t i = 0; i < QPreferences::cache_entries.size(); ++i) {
-        auto& entry = QPreferences::cache_entries[i];
+    QPreferences::for_each_dirty([&](size_t first) {
+        // Already written (or deferred) as part of an earlier namespace group
+        auto& ns_meta = QPreferences::key_metadata[first];
+        size_t ns_index = ns_meta.namespace_index;
+        bool tracked = ns_index != QPreferences::UNTRACKED_NAMESPACE;
+        if (!QPreferences::cache_entries[first].is_dirty() || (tracked && handled[ns_index])) {
+            return;
+        }
+        if (tracked) {
+            handled[ns_index] = true;
+        }
 
-        // Skip uninitialized or clean entries
-        if (!entry.is_initialized() || !entry.is_dirty()) {
-            continue;
+        // Open this namespace once and write all of its dirty entries
+        bool opened = QPreferences::begin_write(prefs, ns_meta.namespace_name, ns_index);
+        if (opened) {
+            ++report.namespaces_opened;
         }
 
-        auto& meta = QPreferences::key_metadata[i];
+        // Packed bools of the group are written once, after all of them
+        void (*flush)(Preferences&, QPreferences::SaveReport&) = nullptr;
+        QPreferences::for_each_dirty([&](size_t i) {
+            auto& meta = QPreferences::key_metadata[i];
+            if (!QPreferences::same_namespace(meta, ns_meta)) {
+                return;
+            }
+            if (opened) {
+                // Typed write or removal through the key's operations table (clears dirty)
+                meta.ops->persist(prefs, QPreferences::cache_entries[i], meta.key, report);
+                if (meta.ops->flush != nullptr) {
+                    flush = meta.ops->flush;
+                }
+            } else {
+                ++report.skipped;  // Stays dirty for a later save
+            }
+        });
 
-        // Open new namespace if needed (namespace batching)
-        if (current_namespace == nullptr || std::strcmp(current_namespace, meta.namespace_name) != 0) {
-            if (current_namespace != nullptr) {
-                prefs.end();  // Close previous namespace
+        if (opened) {
+            if (flush != nullptr) {
+                flush(prefs, report);
             }
-            prefs.begin(meta.namespace_name, false);  // false = read-write
-            current_namespace = meta.namespace_name;
+            prefs.end();
         }
+    });
 
-        // Write value based on type stored in variant
-        std::visit([&prefs, &meta, &entry](auto&& val) {
-            using T = std::decay_t<decltype(val)>;
-            if constexpr (std::is_same_v<T, int32_t>) {
-                prefs.putInt(meta.key_name, val);
-                entry.nvs_value = entry.value;
-            } else if constexpr (std::is_same_v<T, float>) {
-                prefs.putFloat(meta.key_name, val);
-                entry.nvs_value = entry.value;
-            } else if constexpr (std::is_same_v<T, bool>) {
-                prefs.putBool(meta.key_name, val);
-                entry.nvs_value = entry.value;
-            } else if constexpr (std::is_same_v<T, String>) {
-                prefs.putString(meta.key_name, val);
-                entry.nvs_value = entry.value;
+    report.elapsed_us = micros() - start;
+    return report;
+}
+
+/**
+ * @brief Persist dirty preferences incrementally, within a time or key budget.
+ *
+ * Writes dirty keys grouped by namespace like save(), but stops once
+ * budget.max_keys keys were written or budget.max_us microseconds have
+ * passed, and resumes on the next call. A step that stops inside a
+ * namespace leaves it open, so a namespace whose keys span several steps
+ * still costs one begin/end cycle; a step that stops between namespaces
+ * closes the handle. Changes made between steps are picked up by the
+ * current pass if their namespace is still ahead, otherwise by the next one.
+ * Keys deferred by rate limits don't count against max_keys.
+ *
+ * Call it from a real-time loop instead of save() to bound the stall per
+ * iteration (one NVS commit can take tens of milliseconds during a page
+ * erase, so max_us is checked between keys, not during a write).
+ *
+ * @param budget Limits for this call (at least one key is always written)
+ * @param report Receives what this call wrote, removed, deferred or skipped.
+ *        namespaces_opened counts only the opens made by this call
+ * @return true when a pass finished (nothing dirty is left unless it was
+ *         deferred or its namespace failed to open), false if more steps are needed
+ *
+ * Usage:
+ *   void loop() {
+ *       runControlLoop();
+ *       QPreferences::SaveReport report;
+ *       QPrefs::saveStep({.max_keys = 1}, report);  // At most one flash write per tick
+ *   }
+ */
+inline bool saveStep(const QPreferences::SaveBudget& budget, QPreferences::SaveReport& report) {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    auto& state = detail::save_step_state;
+    uint32_t start = micros();
+    report = {};
+
+    for (;;) {
+        size_t id;
+        if (state.open) {
+            // Continue the open namespace past the last visited key
+            id = QPreferences::find_dirty([&](size_t i) {
+                return i >= state.next_id &&
+                       QPreferences::same_namespace(QPreferences::key_metadata[i],
+                                                    QPreferences::key_metadata[state.ns_key]);
+            });
+            if (id == QPreferences::UNREGISTERED_KEY) {
+                detail::end_save_step_namespace(state, report);  // Namespace done
+                continue;
             }
-        }, entry.value);
+        } else {
+            // Next namespace not yet visited in this pass
+            id = detail::next_save_step_key(state);
+            if (id == QPreferences::UNREGISTERED_KEY) {
+                detail::restart_save_step(state, report);  // Pass complete
+                report.elapsed_us = micros() - start;
+                return true;
+            }
+        }
 
-        entry.dirty = false;  // Clear dirty flag after write
-    }
+        size_t written = report.written + report.removed;
+        bool out_of_keys = budget.max_keys != 0 && written >= budget.max_keys;
+        bool out_of_time = budget.max_us != 0 && micros() - start >= budget.max_us;
+        if (written > 0 && (out_of_keys || out_of_time)) {
+            detail::flush_save_step(state, report);  // Nothing saved stays only in RAM
+            report.elapsed_us = micros() - start;
+            return false;  // Resume here next call
+        }
+
+        auto& meta = QPreferences::key_metadata[id];
+        if (!state.open) {
+            if (!QPreferences::begin_write(state.prefs, meta.namespace_name, meta.namespace_index)) {
+                QPreferences::for_each_dirty([&](size_t i) {
+                    if (QPreferences::same_namespace(QPreferences::key_metadata[i], meta)) {
+                        ++report.skipped;  // Stays dirty; retried next pass
+                    }
+                });
+                detail::mark_save_step_visited(state, id);
+                continue;
+            }
+            ++report.namespaces_opened;
+            state.open = true;
+            state.ns_key = id;
+        }
 
-    if (current_namespace != nullptr) {
-        prefs.end();  // Close final namespace
+        meta.ops->persist(state.prefs, QPreferences::cache_entries[id], meta.key, report);  // Clears dirty
+        if (meta.ops->flush != nullptr) {
+            state.flush = meta.ops->flush;
+        }
+        state.next_id = id + 1;
     }
 }
 
+/**
+ * @brief saveStep() without a report.
+ *
+ * Usage:
+ *   QPrefs::saveStep({.max_keys = 1});
+ */
+inline bool saveStep(const QPreferences::SaveBudget& budget) {
+    QPreferences::SaveReport report;
+    return saveStep(budget, report);
+}
+
+/**
+ * @brief Set the global NVS write budget.
+ *
+ * Caps writes (and removals) across all keys at writes_per_hour on average,
+ * allowing bursts up to the full hourly amount. Saves beyond the budget are
+ * deferred: the keys stay dirty and SaveReport::deferred counts them.
+ * Overrides QPREFERENCES_MAX_WRITES_PER_HOUR; the bucket restarts full.
+ *
+ * @param writes_per_hour Budget, or 0 for unlimited
+ *
+ * Usage:
+ *   QPrefs::setWriteBudget(120);  // Average one write every 30 seconds
+ */
+inline void setWriteBudget(uint32_t writes_per_hour) {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    QPreferences::write_budget = {};
+    QPreferences::write_budget.writes_per_hour = writes_per_hour;
+}
+
+/**
+ * @brief Check if any preference has unsaved changes.
+ *
+ * O(1): reads the dirty counter maintained by set(), reset() and save().
+ *
+ * @return true if at least one key is dirty
+ *
+ * Usage:
+ *   if (QPrefs::anyDirty()) {
+ *       QPrefs::save();
+ *   }
+ */
+inline bool anyDirty() {
+    return QPreferences::atomic_read(QPreferences::dirty_count) != 0;
+}
+
 /**
  * @brief Iterate over all registered preference keys.
  *
@@ -404,7 +995,8 @@ inline void save() {
  */
 template<typename Callback>
 void forEach(Callback callback) {
-    for (size_t i = 0; i < QPreferences::next_key_id; ++i) {
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+    for (size_t i = 0; i < count; ++i) {
         auto& meta = QPreferences::key_metadata[i];
         auto& entry = QPreferences::cache_entries[i];
 
@@ -413,7 +1005,8 @@ void forEach(Callback callback) {
             meta.key_name,
             i,
             entry.is_initialized(),
-            entry.is_dirty()
+            entry.is_dirty(),
+            QPreferences::atomic_read(QPreferences::write_counts[i])
         };
         callback(info);
     }
@@ -435,9 +1028,12 @@ void forEach(Callback callback) {
  */
 template<typename Callback>
 void forEachInNamespace(const char* ns, Callback callback) {
-    for (size_t i = 0; i < QPreferences::next_key_id; ++i) {
+    size_t ns_index = QPreferences::find_namespace(ns);
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+
+    for (size_t i = 0; i < count; ++i) {
         auto& meta = QPreferences::key_metadata[i];
-        if (std::strcmp(meta.namespace_name, ns) == 0) {
+        if (QPreferences::in_namespace(meta, ns_index, ns)) {
             auto& entry = QPreferences::cache_entries[i];
 
             QPreferences::PrefInfo info{
@@ -445,7 +1041,8 @@ void forEachInNamespace(const char* ns, Callback callback) {
                 meta.key_name,
                 i,
                 entry.is_initialized(),
-                entry.is_dirty()
+                entry.is_dirty(),
+                QPreferences::atomic_read(QPreferences::write_counts[i])
             };
             callback(info);
         }
@@ -453,45 +1050,197 @@ void forEachInNamespace(const char* ns, Callback callback) {
 }
 
 /**
- * @brief Clear all NVS entries and reset cache to uninitialized state.
+ * @brief Clear all NVS entries and reset cache to default values.
  *
- * Groups keys by namespace and calls Preferences::clear() for each namespace.
- * Resets all cache entries to uninitialized state (nvs_value.reset(), dirty=false).
+ * Calls Preferences::clear() once per registered namespace, then resets every
+ * cache entry to its default value with no NVS value and dirty=false.
  * After factory reset, get(key) will return default values.
  *
  * WARNING: This permanently deletes all stored preference values from flash!
  */
 inline void factoryReset() {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    QPreferences::SaveReport step_report;
+    detail::restart_save_step(detail::save_step_state, step_report);
     Preferences prefs;
-    const char* last_ns = nullptr;
+    std::array<bool, QPreferences::MAX_NAMESPACES> cleared{};
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
 
-    for (size_t i = 0; i < QPreferences::next_key_id; ++i) {
+    for (size_t i = 0; i < count; ++i) {
         auto& meta = QPreferences::key_metadata[i];
+        size_t ns_index = meta.namespace_index;
 
-        // Clear namespace if different from last (batch by namespace)
-        if (last_ns == nullptr || std::strcmp(last_ns, meta.namespace_name) != 0) {
-            if (last_ns != nullptr) {
-                prefs.end();
-            }
-            prefs.begin(meta.namespace_name, false);  // false = read-write
+        // Clear each interned namespace once (untracked ones are cleared per key)
+        if (ns_index == QPreferences::UNTRACKED_NAMESPACE || !cleared[ns_index]) {
+            QPreferences::begin_write(prefs, meta.namespace_name, ns_index);
             prefs.clear();  // Delete all keys in this namespace
-            last_ns = meta.namespace_name;
+            prefs.end();
+            if (ns_index != QPreferences::UNTRACKED_NAMESPACE) {
+                cleared[ns_index] = true;
+            }
         }
 
-        // Reset cache entry to uninitialized state
-        auto& entry = QPreferences::cache_entries[i];
-        entry.nvs_value.reset();
-        entry.dirty = false;
+        // Reset cache entry to its default, clean (nullptr = nothing in NVS)
+        meta.ops->load(nullptr, QPreferences::cache_entries[i], meta.key);
+    }
+}
+
+/**
+ * @brief Summarize flash wear: total writes and the most-written key.
+ *
+ * Per-key counts are available through forEach() (PrefInfo::write_count).
+ * Counts cover this boot only until loadWearCounters() merges the
+ * persisted totals.
+ *
+ * Usage:
+ *   auto wear = QPrefs::wearReport();
+ *   Serial.printf("hottest: %s/%s (%u writes)\n",
+ *       wear.hottest_namespace, wear.hottest_key, wear.hottest_writes);
+ */
+inline QPreferences::WearReport wearReport() {
+    QPreferences::WearReport report;
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t writes = QPreferences::atomic_read(QPreferences::write_counts[i]);
+        report.total_writes += writes;
+        if (writes > report.hottest_writes) {
+            report.hottest_index = i;
+            report.hottest_namespace = QPreferences::key_metadata[i].namespace_name;
+            report.hottest_key = QPreferences::key_metadata[i].key_name;
+            report.hottest_writes = writes;
+        }
+    }
+    return report;
+}
+
+namespace detail {
+    /**
+     * @brief Wear records read from the wear namespace.
+     */
+    struct StoredWear {
+        std::unique_ptr<QPreferences::WearRecord[]> records;
+        size_t count = 0;
+    };
+
+    /**
+     * @brief Read the persisted wear records.
+     * @param prefs Handle open on QPREFERENCES_WEAR_NAMESPACE
+     */
+    inline StoredWear read_wear_records(Preferences& prefs) {
+        StoredWear stored;
+        size_t length = prefs.isKey("counts") ? prefs.getBytesLength("counts") : 0;
+        stored.count = length / sizeof(QPreferences::WearRecord);
+        if (stored.count != 0) {
+            stored.records.reset(new QPreferences::WearRecord[stored.count]);
+            prefs.getBytes("counts", stored.records.get(), stored.count * sizeof(QPreferences::WearRecord));
+        }
+        return stored;
+    }
+
+    /**
+     * @brief Add persisted wear counts to keys registered since the last merge.
+     *
+     * Each key is merged once per boot, so keys that register lazily after
+     * the first call still pick up their lifetime totals. Caller holds nvs_mutex.
+     *
+     * @param stored Records from read_wear_records() (empty if none are persisted)
+     */
+    inline void merge_wear_counters(const StoredWear& stored) {
+        size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+        for (size_t i = QPreferences::wear_merged_keys; i < count; ++i) {
+            uint32_t hash = QPreferences::wear_key_hash(QPreferences::key_metadata[i]);
+            for (size_t r = 0; r < stored.count; ++r) {
+                if (stored.records[r].key_hash == hash) {
+                    QPreferences::atomic_add(QPreferences::write_counts[i], stored.records[r].writes);
+                    break;
+                }
+            }
+        }
+        QPreferences::wear_merged_keys = count;
+    }
+
+    /**
+     * @brief Whether a wear record belongs to one of the first count registered keys.
+     */
+    inline bool is_registered_wear_key(uint32_t hash, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (QPreferences::wear_key_hash(QPreferences::key_metadata[i]) == hash) {
+                return true;
+            }
+        }
+        return false;
     }
+} // namespace detail
 
-    if (last_ns != nullptr) {
+/**
+ * @brief Merge write counts persisted by earlier boots into the counters.
+ *
+ * Optional: saveWearCounters() loads them on first use anyway. Call it early
+ * to make forEach()/wearReport() show lifetime totals right away. Keys that
+ * register later are merged by the next call of either function.
+ */
+inline void loadWearCounters() {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    Preferences prefs;
+    if (prefs.begin(QPREFERENCES_WEAR_NAMESPACE, true)) {
+        detail::merge_wear_counters(detail::read_wear_records(prefs));
         prefs.end();
+    } else {
+        detail::merge_wear_counters({});  // Nothing persisted yet
     }
 }
 
+/**
+ * @brief Persist lifetime write counts to QPREFERENCES_WEAR_NAMESPACE.
+ *
+ * Lazy by design: counting costs RAM only, and the counts reach flash
+ * only when this is called (e.g. hourly, or before a planned reboot), as
+ * a single blob entry. Records of keys not registered (yet) are kept, so
+ * a key that registers lazily later still finds its totals.
+ *
+ * @return true if the counts were written
+ */
+inline bool saveWearCounters() {
+    std::lock_guard<QPreferences::Mutex> io(QPreferences::nvs_mutex);
+    Preferences prefs;
+    if (!prefs.begin(QPREFERENCES_WEAR_NAMESPACE, false)) {
+        return false;
+    }
+    auto stored = detail::read_wear_records(prefs);
+    detail::merge_wear_counters(stored);  // Don't overwrite earlier totals with this boot's
+
+    size_t count = QPreferences::atomic_read(QPreferences::next_key_id);
+    std::unique_ptr<QPreferences::WearRecord[]> records(new QPreferences::WearRecord[count + stored.count]);
+    size_t used = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t writes = QPreferences::atomic_read(QPreferences::write_counts[i]);
+        if (writes != 0) {
+            records[used++] = {QPreferences::wear_key_hash(QPreferences::key_metadata[i]), writes};
+        }
+    }
+    for (size_t r = 0; r < stored.count; ++r) {
+        if (!detail::is_registered_wear_key(stored.records[r].key_hash, count)) {
+            records[used++] = stored.records[r];  // Key not registered this boot (yet)
+        }
+    }
+
+    bool ok = used == 0 || prefs.putBytes("counts", records.get(), used * sizeof(QPreferences::WearRecord)) != 0;
+    prefs.end();
+    return ok;
+}
+
 } // namespace QPrefs
 
-// Convenience: bring PrefKey into global scope for cleaner usage
+// Convenience: bring key definition types into global scope for cleaner usage
 using QPreferences::PrefKey;
+using QPreferences::PrefRegistry;
+using QPreferences::PrefOptions;
+using QPreferences::Baseline;
+using QPreferences::SaveBudget;
+using QPreferences::SaveReport;
+using QPreferences::WearReport;
+using QPreferences::FixedString;
+using QPreferences::FixedVector;
 
 #endif // QPREFERENCES_QPREFERENCES_H
@@ -0,0 +1,120 @@
+#ifndef QPREFERENCES_RATELIMIT_H
+#define QPREFERENCES_RATELIMIT_H
+
+#include <Arduino.h>
+#include <cstdint>
+
+namespace QPreferences {
+
+/**
+ * @brief Default global NVS write budget, in writes per hour (0 = unlimited).
+ *
+ * Override via build flags (e.g., -DQPREFERENCES_MAX_WRITES_PER_HOUR=120)
+ * or at runtime with QPrefs::setWriteBudget().
+ */
+#ifndef QPREFERENCES_MAX_WRITES_PER_HOUR
+#define QPREFERENCES_MAX_WRITES_PER_HOUR 0
+#endif
+
+/**
+ * @brief Token bucket limiting NVS writes across all keys.
+ *
+ * Holds up to writes_per_hour tokens and refills continuously at
+ * writes_per_hour per hour, so short bursts are allowed but the long-run
+ * rate is capped. Levels are kept in token-milliseconds to stay exact in
+ * integer math. Only used under nvs_mutex.
+ */
+struct WriteBudget {
+    static constexpr uint64_t MS_PER_HOUR = 3600000;
+
+    uint32_t writes_per_hour = QPREFERENCES_MAX_WRITES_PER_HOUR;
+    uint64_t level = 0;        ///< Available tokens x MS_PER_HOUR
+    uint32_t last_ms = 0;      ///< Time of the last refill
+    bool started = false;      ///< Bucket filled on first use
+
+    /**
+     * @brief Take one write token if available.
+     * @param now Current time in milliseconds (millis())
+     * @return true if the write may proceed
+     */
+    bool take(uint32_t now) {
+        if (writes_per_hour == 0) {
+            return true;  // Unlimited
+        }
+
+        uint64_t capacity = uint64_t{writes_per_hour} * MS_PER_HOUR;
+        if (!started) {
+            level = capacity;  // Start full
+            started = true;
+        } else {
+            level += uint64_t{now - last_ms} * writes_per_hour;
+            if (level > capacity) {
+                level = capacity;
+            }
+        }
+        last_ms = now;
+
+        if (level < MS_PER_HOUR) {
+            return false;
+        }
+        level -= MS_PER_HOUR;
+        return true;
+    }
+};
+
+/**
+ * @brief The global write budget shared by all save paths.
+ */
+inline WriteBudget write_budget;
+
+/**
+ * @brief Last persisted write of a key with a min_interval_ms option.
+ */
+struct KeyRate {
+    uint32_t last_ms = 0;
+    bool written = false;
+};
+
+/**
+ * @brief Per-key rate state, instantiated only for keys with min_interval_ms.
+ */
+template<typename KeyType>
+inline KeyRate key_rate;
+
+/**
+ * @brief Decide whether a key may be written to NVS now.
+ *
+ * Checks the key's min_interval_ms first, then takes a token from the
+ * global write budget. A refused write is deferred: the caller leaves the
+ * key dirty, and a later save retries it. Caller holds nvs_mutex.
+ *
+ * @tparam KeyType The PrefKey type
+ * @param charge_budget false if the NVS write was already paid for (packed
+ *                      bools joining a pending flush); only min_interval_ms applies
+ * @return true if the write may proceed (and was accounted for)
+ */
+template<typename KeyType>
+bool admit_write(bool charge_budget = true) {
+    constexpr uint32_t min_interval = KeyType::options.min_interval_ms;
+    uint32_t now = millis();
+
+    if constexpr (min_interval != 0) {
+        auto& rate = key_rate<KeyType>;
+        if (rate.written && now - rate.last_ms < min_interval) {
+            return false;
+        }
+    }
+
+    if (charge_budget && !write_budget.take(now)) {
+        return false;
+    }
+
+    if constexpr (min_interval != 0) {
+        key_rate<KeyType> = {now, true};
+    }
+    return true;
+}
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_RATELIMIT_H
@@ -0,0 +1,159 @@
+#ifndef QPREFERENCES_REGISTRY_H
+#define QPREFERENCES_REGISTRY_H
+
+#include <cstddef>
+#include <type_traits>
+#include "CacheEntry.h"
+#include "KeyOps.h"
+
+namespace QPreferences {
+
+/**
+ * @brief Compile-time C-string equality.
+ */
+constexpr bool str_equal(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Check a key type list for two keys with the same namespace and key name.
+ *
+ * Catches both repeated key types and different value types that would
+ * share one NVS entry.
+ */
+template<typename... Keys>
+constexpr bool has_duplicate_keys() {
+    const char* namespaces[] = {Keys::namespace_name...};
+    const char* names[] = {Keys::key_name...};
+    for (size_t i = 0; i < sizeof...(Keys); ++i) {
+        for (size_t j = i + 1; j < sizeof...(Keys); ++j) {
+            if (str_equal(namespaces[i], namespaces[j]) && str_equal(names[i], names[j])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check a key type list for two packed bools with the same pack_bit in one namespace.
+ */
+template<typename... Keys>
+constexpr bool has_duplicate_pack_bits() {
+    const char* namespaces[] = {Keys::namespace_name...};
+    const int8_t bits[] = {Keys::options.pack_bit...};
+    for (size_t i = 0; i < sizeof...(Keys); ++i) {
+        for (size_t j = i + 1; j < sizeof...(Keys); ++j) {
+            if (bits[i] >= 0 && bits[i] == bits[j] && str_equal(namespaces[i], namespaces[j])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Count distinct namespaces in a key type list.
+ */
+template<typename... Keys>
+constexpr size_t count_namespaces() {
+    const char* namespaces[] = {Keys::namespace_name...};
+    size_t count = 0;
+    for (size_t i = 0; i < sizeof...(Keys); ++i) {
+        bool seen = false;
+        for (size_t j = 0; j < i && !seen; ++j) {
+            seen = str_equal(namespaces[i], namespaces[j]);
+        }
+        count += seen ? 0 : 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Position of KeyType in a key type list (sizeof...(Keys) if absent).
+ */
+template<typename KeyType, typename... Keys>
+constexpr size_t key_index() {
+    constexpr bool matches[] = {std::is_same_v<KeyType, Keys>...};
+    for (size_t i = 0; i < sizeof...(Keys); ++i) {
+        if (matches[i]) {
+            return i;
+        }
+    }
+    return sizeof...(Keys);
+}
+
+/**
+ * @brief Declarative, exactly-sized key registry (opt-in).
+ *
+ * Lists every PrefKey of the application in one place. The registry owns
+ * cache storage sized to exactly sizeof...(Keys) slots, assigns each key
+ * its position in the list as a constexpr index, and rejects duplicate
+ * namespace/key pairs, reused pack_bits or too many namespaces at compile time.
+ *
+ * Requires the QPREFERENCES_USE_REGISTRY build flag (in every translation
+ * unit): it disables key self-registration and shrinks the default
+ * QPREFERENCES_MAX_KEYS storage to 0. Keys not listed in the registry
+ * cannot be used.
+ *
+ * @tparam Keys The PrefKey types (deduced from the constructor arguments)
+ *
+ * Usage (build_flags = -DQPREFERENCES_USE_REGISTRY):
+ *   PrefKey<int, "myapp", "count"> countKey{0};
+ *   PrefKey<bool, "myapp", "enabled"> enabledKey{true};
+ *   PrefRegistry registry{countKey, enabledKey};  // Define after the keys
+ *
+ *   static_assert(decltype(registry)::index_of<decltype(enabledKey)>() == 1);
+ */
+template<typename... Keys>
+class PrefRegistry {
+public:
+    /// Number of keys (and cache slots) in this registry
+    static constexpr size_t size = sizeof...(Keys);
+
+    /**
+     * @brief Compile-time cache index of a key in this registry.
+     * @tparam KeyType The PrefKey type (must be listed in the registry)
+     */
+    template<typename KeyType>
+    static constexpr size_t index_of() {
+        constexpr size_t index = key_index<KeyType, Keys...>();
+        static_assert(index < size, "PrefRegistry: key is not listed in this registry");
+        return index;
+    }
+
+    /**
+     * @brief Install exactly-sized storage and register all keys in list order.
+     * @param keys The key instances (copied; they supply default values)
+     */
+    explicit PrefRegistry(const Keys&... keys) {
+#ifndef QPREFERENCES_USE_REGISTRY
+        static_assert(sizeof...(Keys) == 0, "PrefRegistry requires the QPREFERENCES_USE_REGISTRY build flag");
+#endif
+        static_assert(size > 0, "PrefRegistry: at least one key is required");
+        static_assert(!has_duplicate_keys<Keys...>(), "PrefRegistry: duplicate namespace/key pair");
+        static_assert(!has_duplicate_pack_bits<Keys...>(), "PrefRegistry: pack_bit used twice in one namespace");
+        static_assert(count_namespaces<Keys...>() <= MAX_NAMESPACES,
+                      "PrefRegistry: too many namespaces (increase QPREFERENCES_MAX_NAMESPACES)");
+
+        install_storage(storage);
+        (QPrefs::detail::register_key_type(keys), ...);
+
+        // Registration order matches list order on fresh storage
+        assert(((QPrefs::detail::key_id<Keys> == index_of<Keys>()) && ...));
+    }
+
+private:
+    static inline KeyStorage<size> storage;
+};
+
+template<typename... Keys>
+PrefRegistry(const Keys&...) -> PrefRegistry<Keys...>;
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_REGISTRY_H
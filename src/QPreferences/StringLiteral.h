@@ -2,9 +2,59 @@
 #define QPREFERENCES_STRINGLITERAL_H
 
 #include <cstddef>
+#include <cstdint>
 
 namespace QPreferences {
 
+/**
+ * @brief 32-bit FNV-1a hash of a null-terminated string.
+ *
+ * constexpr so namespace names captured as StringLiteral NTTPs hash at
+ * compile time; the same function hashes runtime names for lookups.
+ *
+ * @param str Null-terminated string
+ * @return The hash value
+ */
+constexpr uint32_t fnv1a(const char* str) {
+    uint32_t hash = 2166136261u;
+    for (; *str != '\0'; ++str) {
+        hash ^= static_cast<uint8_t>(*str);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Continue an FNV-1a hash over a null-terminated string.
+ *
+ * @param hash Hash of the preceding characters (from fnv1a())
+ * @param str Characters to append
+ * @return The combined hash
+ */
+constexpr uint32_t fnv1a_append(uint32_t hash, const char* str) {
+    for (; *str != '\0'; ++str) {
+        hash ^= static_cast<uint8_t>(*str);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 32-bit FNV-1a hash of a byte range.
+ *
+ * @param data Pointer to the bytes
+ * @param length Number of bytes
+ * @return The hash value
+ */
+constexpr uint32_t fnv1a(const char* data, std::size_t length) {
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 /**
  * @brief Compile-time string literal capture for C++20 NTTP usage.
  *
@@ -43,6 +93,14 @@ struct StringLiteral {
     constexpr std::size_t size() const {
         return N - 1;
     }
+
+    /**
+     * @brief Get the FNV-1a hash of the string (see fnv1a()).
+     * @return The hash value
+     */
+    constexpr uint32_t hash() const {
+        return fnv1a(value);
+    }
 };
 
 } // namespace QPreferences
@@ -0,0 +1,198 @@
+#ifndef QPREFERENCES_SYNC_H
+#define QPREFERENCES_SYNC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#endif
+
+#if defined(QPREFERENCES_THREAD_SAFE) && defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * @brief Places ISR-callable functions in IRAM on ESP32.
+ *
+ * Keeps them callable while flash cache is disabled, e.g. during an NVS commit.
+ */
+#if defined(ESP_PLATFORM)
+#define QPREFERENCES_ISR_ATTR IRAM_ATTR
+#else
+#define QPREFERENCES_ISR_ATTR
+#endif
+
+namespace QPreferences {
+
+/**
+ * @brief Whether the cache is synchronized for multi-task access.
+ *
+ * Enabled by the QPREFERENCES_THREAD_SAFE build flag (define it in every
+ * translation unit). Without it, every primitive below compiles to a plain
+ * load/store or a no-op, so single-task sketches pay nothing.
+ */
+#ifdef QPREFERENCES_THREAD_SAFE
+inline constexpr bool thread_safe = true;
+#else
+inline constexpr bool thread_safe = false;
+#endif
+
+/**
+ * @brief Lock type that does nothing (single-task builds, lock-free values).
+ */
+struct NoLock {
+    void lock() {}
+    void unlock() {}
+};
+
+#ifdef QPREFERENCES_THREAD_SAFE
+
+/**
+ * @brief Short critical section for updating one cache entry.
+ *
+ * A FreeRTOS spinlock on ESP32 (also masks interrupts on the calling core,
+ * so it works across both cores and never deadlocks against a preempting
+ * task), a spinning atomic_flag elsewhere. Never held across NVS access,
+ * heap allocation or user callbacks.
+ */
+class SpinLock {
+public:
+#if defined(ESP_PLATFORM)
+    void lock() { portENTER_CRITICAL(&mux_); }
+    void unlock() { portEXIT_CRITICAL(&mux_); }
+
+private:
+    portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+#else
+    void lock() {
+        while (flag_.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    void unlock() { flag_.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+#endif
+};
+
+/**
+ * @brief Blocking lock for NVS I/O and non-scalar values (may sleep).
+ */
+using Mutex = std::mutex;
+
+#else
+
+using SpinLock = NoLock;
+using Mutex = NoLock;
+
+#endif // QPREFERENCES_THREAD_SAFE
+
+/**
+ * @brief Whether values of type T are read and written with single atomic accesses.
+ *
+ * Word-sized scalars: lock-free on ESP32 and read torn-free without any lock.
+ * Other types (String, 64-bit values) are guarded by a per-key Mutex.
+ */
+template<typename T>
+inline constexpr bool is_lock_free_value = std::is_arithmetic_v<T> && sizeof(T) <= sizeof(void*);
+
+/// Load a shared variable (acquire) in thread-safe builds, plain read otherwise
+template<typename T>
+T atomic_read(const T& ref) {
+    if constexpr (thread_safe) {
+        return std::atomic_ref<T>(const_cast<T&>(ref)).load(std::memory_order_acquire);
+    } else {
+        return ref;
+    }
+}
+
+/// Store a shared variable (release) in thread-safe builds, plain write otherwise
+template<typename T>
+void atomic_write(T& ref, T value) {
+    if constexpr (thread_safe) {
+        std::atomic_ref<T>(ref).store(value, std::memory_order_release);
+    } else {
+        ref = value;
+    }
+}
+
+/// ref |= bits, returning the previous value
+template<typename T>
+T atomic_fetch_or(T& ref, T bits) {
+    if constexpr (thread_safe) {
+        return std::atomic_ref<T>(ref).fetch_or(bits, std::memory_order_acq_rel);
+    } else {
+        T previous = ref;
+        ref = static_cast<T>(ref | bits);
+        return previous;
+    }
+}
+
+/// ref &= bits, returning the previous value
+template<typename T>
+T atomic_fetch_and(T& ref, T bits) {
+    if constexpr (thread_safe) {
+        return std::atomic_ref<T>(ref).fetch_and(bits, std::memory_order_acq_rel);
+    } else {
+        T previous = ref;
+        ref = static_cast<T>(ref & bits);
+        return previous;
+    }
+}
+
+/// ref += delta (wraps for unsigned types)
+template<typename T>
+void atomic_add(T& ref, T delta) {
+    if constexpr (thread_safe) {
+        std::atomic_ref<T>(ref).fetch_add(delta, std::memory_order_acq_rel);
+    } else {
+        ref += delta;
+    }
+}
+
+/**
+ * @brief Serializes all NVS access (loads, saves, factoryReset).
+ *
+ * Also guards the namespace negative cache, which is only touched around
+ * begin()/end(). Cached get()/set() of loaded keys never take it.
+ */
+inline Mutex nvs_mutex;
+
+/**
+ * @brief Serializes key registration (slot assignment and namespace interning).
+ */
+inline SpinLock registry_lock;
+
+/**
+ * @brief Serializes the one-time copy of each key type's first instance.
+ *
+ * A Mutex rather than registry_lock: copying a String default allocates.
+ */
+inline Mutex key_copy_mutex;
+
+/// Number of striped entry locks shared by scalar and bool keys
+static constexpr size_t ENTRY_LOCK_STRIPES = 8;
+
+/**
+ * @brief Striped writer locks for keys with lock-free values.
+ *
+ * Writers hold their entry's stripe while storing the value and recomputing
+ * the dirty flag, so a save() can't clear a flag that a concurrent set()
+ * just raised. Readers don't lock.
+ */
+inline SpinLock entry_locks[ENTRY_LOCK_STRIPES];
+
+/**
+ * @brief Stripe lock for the cache entry at address entry.
+ */
+inline SpinLock& entry_lock(const void* entry) {
+    return entry_locks[reinterpret_cast<uintptr_t>(entry) % ENTRY_LOCK_STRIPES];
+}
+
+} // namespace QPreferences
+
+#endif // QPREFERENCES_SYNC_H
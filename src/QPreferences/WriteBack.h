@@ -0,0 +1,243 @@
+#ifndef QPREFERENCES_WRITEBACK_H
+#define QPREFERENCES_WRITEBACK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+#include "QPreferences.h"
+
+#ifdef QPREFERENCES_THREAD_SAFE
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+#endif // QPREFERENCES_THREAD_SAFE
+
+namespace QPreferences {
+
+/**
+ * @brief Timing and task settings for the write-back engine.
+ */
+struct WriteBackConfig {
+    /// Flush once no value has changed for this long
+    uint32_t debounce_ms = 2000;
+
+    /// Flush at the latest this long after the first unsaved change (0 = no bound)
+    uint32_t max_staleness_ms = 60000;
+
+    /// How often the task checks the dirty set
+    uint32_t poll_ms = 100;
+
+    /// Task stack size in bytes (ESP32 only)
+    uint32_t stack_size = 4096;
+
+    /// Task priority (ESP32 only)
+    uint8_t priority = 1;
+
+    /// Core to pin the task to, or -1 for no affinity (ESP32 only)
+    int8_t core = -1;
+};
+
+/**
+ * @brief Decides when dirty preferences should be flushed.
+ *
+ * A flush is due once the dirty set has been quiet for debounce_ms, or
+ * once the oldest unsaved change is max_staleness_ms old, whichever comes
+ * first. Activity is detected by polling dirty_count and change_count, so
+ * set() pays no timestamping cost; timings are accurate to the poll period.
+ * Each flush restarts the window, so continuous changes (or keys left dirty
+ * by rate limits) cost one flush per window, not one per poll.
+ *
+ * Used by the write-back task, and usable directly from loop() for
+ * single-threaded sketches:
+ *
+ *   WriteBackPolicy policy{WriteBackConfig{.debounce_ms = 5000}};
+ *   void loop() {
+ *       if (policy.due(millis())) QPrefs::save();
+ *   }
+ */
+class WriteBackPolicy {
+public:
+    explicit WriteBackPolicy(const WriteBackConfig& config) : config_(config) {}
+
+    /**
+     * @brief Check whether a flush is due.
+     * @param now Current time in milliseconds (millis(); wraparound-safe)
+     * @return true if save() should be called now
+     */
+    bool due(uint32_t now) {
+        uint32_t changes = atomic_read(change_count);
+        if (atomic_read(dirty_count) == 0) {
+            pending_ = false;  // Saved, or every change reverted
+            return false;
+        }
+
+        if (!pending_) {
+            // First poll that sees unsaved changes
+            pending_ = true;
+            first_dirty_ms_ = now;
+            last_change_ms_ = now;
+            seen_changes_ = changes;
+        } else if (changes != seen_changes_) {
+            seen_changes_ = changes;
+            last_change_ms_ = now;
+        }
+
+        bool quiet = now - last_change_ms_ >= config_.debounce_ms;
+        bool stale = config_.max_staleness_ms != 0 && now - first_dirty_ms_ >= config_.max_staleness_ms;
+        if (!quiet && !stale) {
+            return false;
+        }
+
+        // Flushing now: whatever stays dirty starts a new window
+        first_dirty_ms_ = now;
+        last_change_ms_ = now;
+        seen_changes_ = changes;
+        return true;
+    }
+
+    const WriteBackConfig& config() const { return config_; }
+
+private:
+    WriteBackConfig config_;
+    bool pending_ = false;
+    uint32_t first_dirty_ms_ = 0;
+    uint32_t last_change_ms_ = 0;
+    uint32_t seen_changes_ = 0;
+};
+
+// The write-back task saves while other tasks call set(). Without
+// synchronization a set() that interleaves with a flush may be marked clean
+// without reaching flash, so the task only exists in thread-safe builds.
+#ifdef QPREFERENCES_THREAD_SAFE
+
+/**
+ * @brief Shared state of the background write-back task.
+ */
+struct WriteBackState {
+    std::atomic<bool> running{false};   ///< Cleared by stopWriteBack() to end the task
+    std::atomic<bool> active{false};    ///< Set while the task body is executing
+#if defined(ESP_PLATFORM)
+    TaskHandle_t task = nullptr;
+#else
+    std::thread thread;
+#endif
+};
+
+inline WriteBackState writeback_state;
+
+/**
+ * @brief Write-back task body: poll the policy and flush through batch save().
+ */
+inline void writeback_loop(const WriteBackConfig& config) {
+    WriteBackPolicy policy{config};
+    while (writeback_state.running.load()) {
+        if (policy.due(static_cast<uint32_t>(millis()))) {
+            QPrefs::save();
+        }
+#if defined(ESP_PLATFORM)
+        vTaskDelay(pdMS_TO_TICKS(config.poll_ms));
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.poll_ms));
+#endif
+    }
+}
+
+#endif // QPREFERENCES_THREAD_SAFE
+
+} // namespace QPreferences
+
+namespace QPrefs {
+
+#ifdef QPREFERENCES_THREAD_SAFE
+
+/**
+ * @brief Start the background write-back task.
+ *
+ * Periodically flushes dirty preferences with save(), debounced so a burst
+ * of set() calls costs one flash write, and bounded so no change stays
+ * unsaved longer than max_staleness_ms. Runs as a FreeRTOS task on ESP32
+ * and as a std::thread in host builds. Does nothing if already running.
+ *
+ * Only declared with QPREFERENCES_THREAD_SAFE. Single-task sketches drive
+ * a WriteBackPolicy from loop() instead.
+ *
+ * @param config Debounce, staleness and task settings
+ * @return true if the task was started
+ *
+ * Usage:
+ *   QPrefs::startWriteBack({.debounce_ms = 2000, .max_staleness_ms = 30000});
+ */
+inline bool startWriteBack(const QPreferences::WriteBackConfig& config = {}) {
+    auto& state = QPreferences::writeback_state;
+    if (state.running.exchange(true)) {
+        return false;  // Already running
+    }
+    state.active = true;
+
+#if defined(ESP_PLATFORM)
+    static QPreferences::WriteBackConfig task_config;
+    task_config = config;
+    auto body = [](void* arg) {
+        QPreferences::writeback_loop(*static_cast<const QPreferences::WriteBackConfig*>(arg));
+        QPreferences::writeback_state.active = false;
+        vTaskDelete(nullptr);
+    };
+    BaseType_t created = xTaskCreatePinnedToCore(
+        body, "qprefs_wb", config.stack_size, &task_config, config.priority, &state.task,
+        config.core < 0 ? tskNO_AFFINITY : static_cast<BaseType_t>(config.core));
+    if (created != pdPASS) {
+        state.running = false;
+        state.active = false;
+        return false;
+    }
+#else
+    state.thread = std::thread([config] {
+        QPreferences::writeback_loop(config);
+        QPreferences::writeback_state.active = false;
+    });
+#endif
+    return true;
+}
+
+/**
+ * @brief Stop the write-back task and persist anything still dirty.
+ *
+ * Blocks until the task has exited (at most one poll period).
+ */
+inline void stopWriteBack() {
+    auto& state = QPreferences::writeback_state;
+    if (!state.running.exchange(false)) {
+        return;  // Not running
+    }
+
+#if defined(ESP_PLATFORM)
+    while (state.active.load()) {
+        vTaskDelay(1);
+    }
+    state.task = nullptr;
+#else
+    state.thread.join();
+#endif
+
+    save();  // Final flush
+}
+
+/**
+ * @brief Check whether the write-back task is running.
+ */
+inline bool isWriteBackRunning() {
+    return QPreferences::writeback_state.running.load();
+}
+
+#endif // QPREFERENCES_THREAD_SAFE
+
+} // namespace QPrefs
+
+using QPreferences::WriteBackConfig;
+using QPreferences::WriteBackPolicy;
+
+#endif // QPREFERENCES_WRITEBACK_H
@@ -0,0 +1,99 @@
+/**
+ * @file array_test.ino
+ * @brief Test sketch for std::array and FixedVector preferences.
+ *
+ * Tests:
+ * 1. Element set - only the written element is dirty; reverting it is clean
+ * 2. Out of range - set(key, index, value) past the size changes nothing
+ * 3. FixedVector - length changes, and only the used elements are stored
+ * 4. Stale blob - a blob that no longer fits reports every element dirty
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+#include <Preferences.h>
+
+PrefKey<std::array<float, 4>, "arrtest", "gains"> gainsKey{{1.0f, 1.0f, 1.0f, 1.0f}};
+PrefKey<FixedVector<uint16_t, 8>, "arrtest", "times"> timesKey{{360, 1080}};
+// constexpr: registered and loaded on first access, after the old blob is written
+constexpr PrefKey<std::array<int16_t, 4>, "arrtest", "levels"> levelsKey{{1, 2, 3, 4}};
+
+// Size of an entry read straight from NVS (0 if missing)
+size_t nvsSize(const char* key) {
+    Preferences prefs;
+    if (!prefs.begin("arrtest", true)) {
+        return 0;
+    }
+    size_t size = prefs.isKey(key) ? prefs.getBytesLength(key) : 0;
+    prefs.end();
+    return size;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Array Preference Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: per-element dirty tracking
+    Serial.println("--- Test 1: Element set ---");
+    QPrefs::set(gainsKey, 2, 0.5f);
+    Serial.printf("isDirty(gains): %d (expect 1)\n", QPrefs::isDirty(gainsKey));
+    Serial.printf("isDirty(gains, 2): %d (expect 1)\n", QPrefs::isDirty(gainsKey, 2));
+    Serial.printf("isDirty(gains, 1): %d (expect 0)\n", QPrefs::isDirty(gainsKey, 1));
+    QPrefs::save(gainsKey);
+    QPrefs::set(gainsKey, 0, 0.8f);
+    Serial.printf("After save, isDirty(gains, 0): %d (expect 1)\n", QPrefs::isDirty(gainsKey, 0));
+    Serial.printf("After save, isDirty(gains, 2): %d (expect 0)\n", QPrefs::isDirty(gainsKey, 2));
+    QPrefs::set(gainsKey, 0, 1.0f);
+    Serial.printf("Reverted, isDirty(gains): %d (expect 0)\n", QPrefs::isDirty(gainsKey));
+    Serial.println();
+
+    // Test 2: index past the size
+    Serial.println("--- Test 2: Out of range ---");
+    Serial.printf("set(gains, 4, ...): %d (expect 0)\n", QPrefs::set(gainsKey, 4, 9.0f));
+    Serial.printf("set(times, 2, ...): %d (expect 0, size is 2)\n", QPrefs::set(timesKey, 2, uint16_t{1}));
+    Serial.printf("isDirty(times): %d (expect 0)\n", QPrefs::isDirty(timesKey));
+    Serial.println();
+
+    // Test 3: variable length
+    Serial.println("--- Test 3: FixedVector ---");
+    QPrefs::update(timesKey, [](FixedVector<uint16_t, 8>& v) { v.push_back(1320); });
+    Serial.printf("size: %u (expect 3)\n", static_cast<unsigned>(QPrefs::view(timesKey).size()));
+    Serial.printf("isDirty(times, 2): %d (expect 1, only on one side)\n", QPrefs::isDirty(timesKey, 2));
+    Serial.printf("isDirty(times, 0): %d (expect 0)\n", QPrefs::isDirty(timesKey, 0));
+    QPrefs::save(timesKey);
+    Serial.printf("NVS size: %u (expect %u, header + 3 elements)\n",
+                  static_cast<unsigned>(nvsSize("times")), static_cast<unsigned>(4 + 3 * sizeof(uint16_t)));
+    QPrefs::update(timesKey, [](FixedVector<uint16_t, 8>& v) { v.resize(2); });
+    Serial.printf("Shrunk, isDirty(times): %d (expect 1)\n", QPrefs::isDirty(timesKey));
+    QPrefs::save(timesKey);
+    Serial.printf("Back at default, isSaved(times): %d (expect 0)\n", QPrefs::isSaved(timesKey));
+    Serial.println();
+
+    // Test 4: a blob of an older, shorter array
+    Serial.println("--- Test 4: Stale blob ---");
+    Preferences prefs;
+    prefs.begin("arrtest", false);
+    int16_t oldLevels[2] = {7, 7};
+    prefs.putBytes("levels", oldLevels, sizeof(oldLevels));
+    prefs.end();
+    Serial.printf("get(levels)[0]: %d (expect 1, the default)\n", QPrefs::get(levelsKey)[0]);
+    Serial.printf("isDirty(levels): %d (expect 1)\n", QPrefs::isDirty(levelsKey));
+    Serial.printf("isDirty(levels, 0): %d (expect 1)\n", QPrefs::isDirty(levelsKey, 0));
+    Serial.printf("isDirty(levels, 3): %d (expect 1)\n", QPrefs::isDirty(levelsKey, 3));
+    QPrefs::save(levelsKey);
+    Serial.printf("After save, isDirty(levels, 0): %d (expect 0)\n", QPrefs::isDirty(levelsKey, 0));
+    Serial.printf("NVS size: %u (expect 0, removed)\n", static_cast<unsigned>(nvsSize("levels")));
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file blob_test.ino
+ * @brief Test sketch for trivially copyable struct (blob) preferences.
+ *
+ * Tests:
+ * 1. Persist - a struct is written as one blob of its exact size
+ * 2. Dirty detection - memcmp for plain structs, operator== when defined
+ * 3. Stale blob - a blob of the wrong size (layout changed) loads the
+ *    default, stays dirty, and the next save replaces or removes it
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+#include <Preferences.h>
+
+struct Calibration {
+    float gain[4];
+    int32_t offset[4];
+};
+
+// Compares only the fields that matter
+struct Thresholds {
+    int16_t low;
+    int16_t high;
+    bool operator==(const Thresholds& other) const { return low == other.low && high == other.high; }
+};
+
+PrefKey<Calibration, "blobtest", "cal"> calKey{Calibration{{1, 1, 1, 1}, {0, 0, 0, 0}}};
+PrefKey<Thresholds, "blobtest", "limits"> limitsKey{Thresholds{10, 90}};
+// constexpr: registered and loaded on first access, after the old layout is written
+constexpr PrefKey<Calibration, "blobtest", "stale"> staleKey{Calibration{{1, 1, 1, 1}, {0, 0, 0, 0}}};
+constexpr PrefKey<Calibration, "blobtest", "stale2"> stale2Key{Calibration{{1, 1, 1, 1}, {0, 0, 0, 0}}};
+
+// Size of an entry read straight from NVS (0 if missing)
+size_t nvsSize(const char* key) {
+    Preferences prefs;
+    if (!prefs.begin("blobtest", true)) {
+        return 0;
+    }
+    size_t size = prefs.isKey(key) ? prefs.getBytesLength(key) : 0;
+    prefs.end();
+    return size;
+}
+
+// Store a blob of an older, smaller layout under a key
+void writeOldLayout(const char* key) {
+    Preferences prefs;
+    prefs.begin("blobtest", false);
+    float oldGain[2] = {3, 3};
+    prefs.putBytes(key, oldGain, sizeof(oldGain));
+    prefs.end();
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Blob Preference Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: one blob write
+    Serial.println("--- Test 1: Persist ---");
+    QPrefs::update(calKey, [](Calibration& c) { c.offset[2] = -12; });
+    auto report = QPrefs::save(calKey);
+    Serial.printf("bytes_written: %u (expect %u)\n",
+                  static_cast<unsigned>(report.bytes_written), static_cast<unsigned>(sizeof(Calibration)));
+    Serial.printf("NVS size: %u (expect %u)\n",
+                  static_cast<unsigned>(nvsSize("cal")), static_cast<unsigned>(sizeof(Calibration)));
+    Serial.printf("view().offset[2]: %d (expect -12)\n", static_cast<int>(QPrefs::view(calKey).offset[2]));
+    Serial.println();
+
+    // Test 2: a change and its revert
+    Serial.println("--- Test 2: Dirty detection ---");
+    QPrefs::update(calKey, [](Calibration& c) { c.gain[0] = 2.5f; });
+    Serial.printf("memcmp change isDirty: %d (expect 1)\n", QPrefs::isDirty(calKey));
+    QPrefs::update(calKey, [](Calibration& c) { c.gain[0] = 1.0f; });
+    Serial.printf("memcmp revert isDirty: %d (expect 0)\n", QPrefs::isDirty(calKey));
+    QPrefs::set(limitsKey, Thresholds{10, 95});
+    Serial.printf("operator== change isDirty: %d (expect 1)\n", QPrefs::isDirty(limitsKey));
+    QPrefs::set(limitsKey, Thresholds{10, 90});
+    Serial.printf("operator== revert isDirty: %d (expect 0)\n", QPrefs::isDirty(limitsKey));
+    Serial.println();
+
+    // Test 3: old layouts in NVS, written before the keys are first read
+    Serial.println("--- Test 3: Stale blob ---");
+    writeOldLayout("stale");
+    writeOldLayout("stale2");
+    Serial.printf("gain[0]: %.1f (expect 1.0, the default)\n", QPrefs::get(staleKey).gain[0]);
+    Serial.printf("isSaved: %d (expect 1, old blob still stored)\n", QPrefs::isSaved(staleKey));
+    Serial.printf("isDirty: %d (expect 1)\n", QPrefs::isDirty(staleKey));
+    QPrefs::set(staleKey, QPrefs::get(staleKey));  // Setting the default keeps it dirty
+    Serial.printf("isDirty after set(default): %d (expect 1)\n", QPrefs::isDirty(staleKey));
+    QPrefs::update(stale2Key, [](Calibration& c) { c.offset[0] = 5; });
+    report = QPrefs::save();
+    Serial.printf("save() removed: %u (expect 1)\n", static_cast<unsigned>(report.removed));
+    Serial.printf("save() written: %u (expect 1)\n", static_cast<unsigned>(report.written));
+    Serial.printf("NVS size stale: %u (expect 0)\n", static_cast<unsigned>(nvsSize("stale")));
+    Serial.printf("NVS size stale2: %u (expect %u)\n",
+                  static_cast<unsigned>(nvsSize("stale2")), static_cast<unsigned>(sizeof(Calibration)));
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -34,6 +34,33 @@ PrefKey<String, "myapp", "username"> usernameKey{String("default")};
 PrefKey<int, "exactly15chars_", "key"> maxNsKey{0};
 PrefKey<int, "ns", "exactly15chars_"> maxKeyKey{0};
 
+// Fixed-width integers, stored at their own width
+PrefKey<int8_t, "widths", "i8"> i8Key{-5};
+PrefKey<uint8_t, "widths", "u8"> u8Key{200};
+PrefKey<int16_t, "widths", "i16"> i16Key{-300};
+PrefKey<uint16_t, "widths", "u16"> u16Key{60000};
+PrefKey<uint32_t, "widths", "u32"> u32Key{4000000000u};
+PrefKey<int64_t, "widths", "i64"> i64Key{-1};
+PrefKey<uint64_t, "widths", "u64"> u64Key{0xFFFFFFFFFFull};
+
+// Heap-free string; literal length checked against the capacity
+PrefKey<FixedString<32>, "myapp", "ssid"> ssidKey{"default"};
+
+// Trivially copyable struct, stored as one blob
+struct Calibration {
+    float gain[4];
+    int32_t offset[4];
+};
+PrefKey<Calibration, "cal", "table"> calKey{Calibration{}};
+
+// Arrays, stored as one blob each
+PrefKey<std::array<float, 4>, "audio", "gains"> gainsKey{{1.0f, 1.0f, 1.0f, 1.0f}};
+PrefKey<FixedVector<uint16_t, 8>, "sched", "times"> timesKey{{360, 1080}};
+
+// Per-key options
+PrefKey<bool, "flags", "beta", PrefOptions{.pack_bit = 0}> betaKey{false};
+PrefKey<float, "sensor", "temp", PrefOptions{.abs_epsilon = 0.1f}> tempKey{20.0f};
+
 // =============================================================================
 // Compile-time validation tests
 // Uncomment any of these lines to verify they produce compile errors:
@@ -48,6 +75,18 @@ PrefKey<int, "ns", "exactly15chars_"> maxKeyKey{0};
 // ERROR: Both namespace and key exceed 15 characters
 // PrefKey<int, "namespace_too_long", "key_name_too_long"> badBoth{0};
 
+// ERROR: Default value doesn't fit the integer width (narrowing)
+// PrefKey<uint8_t, "x", "small"> badNarrow{300};
+
+// ERROR: FixedString literal longer than the capacity
+// PrefKey<FixedString<4>, "x", "short"> badFixed{"too long"};
+
+// ERROR: pack_bit on a non-bool key
+// PrefKey<int, "x", "packed", PrefOptions{.pack_bit = 0}> badPack{0};
+
+// ERROR: Negative dead-band
+// PrefKey<float, "x", "temp", PrefOptions{.abs_epsilon = -0.5f}> badEpsilon{0.0f};
+
 // =============================================================================
 // Setup and loop - verify member access compiles
 // =============================================================================
@@ -113,6 +152,20 @@ void setup() {
     Serial.print(" = ");
     Serial.println(usernameKey.default_value);
 
+    Serial.print("  FixedString<32> ");
+    Serial.print(ssidKey.namespace_name);
+    Serial.print("/");
+    Serial.print(ssidKey.key_name);
+    Serial.print(" = ");
+    Serial.println(ssidKey.default_value.c_str());
+
+    Serial.print("  FixedVector<uint16_t, 8> ");
+    Serial.print(timesKey.namespace_name);
+    Serial.print("/");
+    Serial.print(timesKey.key_name);
+    Serial.print(" size = ");
+    Serial.println(static_cast<unsigned>(timesKey.default_value.size()));
+
     Serial.println();
     Serial.println("=== Compile Check PASSED ===");
 }
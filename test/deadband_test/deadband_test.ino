@@ -0,0 +1,73 @@
+/**
+ * @file deadband_test.ino
+ * @brief Test sketch for dead-band dirty detection (abs_epsilon / rel_epsilon).
+ *
+ * Tests:
+ * 1. abs_epsilon - changes within the band of the default are clean
+ * 2. After save - the band moves to the saved value
+ * 3. rel_epsilon - the band scales with the value (integer key)
+ * 4. No options - any change is dirty
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+
+PrefKey<float, "bandtest", "temp", PrefOptions{.abs_epsilon = 0.5f}> tempKey{20.0f};
+PrefKey<int, "bandtest", "rpm", PrefOptions{.rel_epsilon = 0.1f}> rpmKey{1000};
+PrefKey<float, "bandtest", "exact"> exactKey{20.0f};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Dead-Band Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: compared against the default while nothing is saved
+    Serial.println("--- Test 1: abs_epsilon = 0.5 ---");
+    QPrefs::set(tempKey, 20.3f);
+    Serial.printf("20.0 -> 20.3 isDirty: %d (expect 0)\n", QPrefs::isDirty(tempKey));
+    Serial.printf("get(): %.1f (expect 20.3, RAM keeps the exact value)\n", QPrefs::get(tempKey));
+    QPrefs::set(tempKey, 20.7f);
+    Serial.printf("20.0 -> 20.7 isDirty: %d (expect 1)\n", QPrefs::isDirty(tempKey));
+    Serial.println();
+
+    // Test 2: after a save the band is centred on the stored value
+    Serial.println("--- Test 2: After save ---");
+    QPrefs::save(tempKey);
+    QPrefs::set(tempKey, 21.1f);
+    Serial.printf("20.7 -> 21.1 isDirty: %d (expect 0)\n", QPrefs::isDirty(tempKey));
+    QPrefs::set(tempKey, 20.3f);
+    Serial.printf("20.7 -> 20.3 isDirty: %d (expect 0)\n", QPrefs::isDirty(tempKey));
+    QPrefs::set(tempKey, 20.0f);
+    Serial.printf("20.7 -> 20.0 isDirty: %d (expect 1)\n", QPrefs::isDirty(tempKey));
+    auto report = QPrefs::save();
+    Serial.printf("save() removed: %u (expect 1, back at default)\n", static_cast<unsigned>(report.removed));
+    Serial.println();
+
+    // Test 3: relative band of 10% of the larger magnitude
+    Serial.println("--- Test 3: rel_epsilon = 0.1 ---");
+    QPrefs::set(rpmKey, 1090);
+    Serial.printf("1000 -> 1090 isDirty: %d (expect 0)\n", QPrefs::isDirty(rpmKey));
+    QPrefs::set(rpmKey, 1120);
+    Serial.printf("1000 -> 1120 isDirty: %d (expect 1)\n", QPrefs::isDirty(rpmKey));
+    QPrefs::save(rpmKey);
+    QPrefs::set(rpmKey, 1200);
+    Serial.printf("1120 -> 1200 isDirty: %d (expect 0)\n", QPrefs::isDirty(rpmKey));
+    Serial.println();
+
+    // Test 4: without options the smallest change is dirty
+    Serial.println("--- Test 4: No options ---");
+    QPrefs::set(exactKey, 20.01f);
+    Serial.printf("20.0 -> 20.01 isDirty: %d (expect 1)\n", QPrefs::isDirty(exactKey));
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file fixed_string_test.ino
+ * @brief Test sketch for FixedString<N> preferences (heap-free strings).
+ *
+ * Tests:
+ * 1. Capacity and truncation - assign() keeps at most N characters
+ * 2. Persist - stored as a regular NVS string, readable as String
+ * 3. Dirty tracking - a change and its revert
+ * 4. Too long in NVS - a stored string over capacity loads the default
+ *    and stays dirty until the next save replaces it
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+#include <Preferences.h>
+
+PrefKey<FixedString<8>, "fstrtest", "ssid"> ssidKey{"default"};
+// constexpr: registered and loaded on first access, after the long string is written
+constexpr PrefKey<FixedString<4>, "fstrtest", "short"> shortKey{"abc"};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== FixedString Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: truncation at capacity
+    Serial.println("--- Test 1: Capacity and truncation ---");
+    FixedString<8> value;
+    Serial.printf("capacity: %u (expect 8)\n", static_cast<unsigned>(FixedString<8>::capacity));
+    Serial.printf("assign(\"home\"): %d (expect 1)\n", value.assign("home"));
+    Serial.printf("assign(\"far-too-long\"): %d (expect 0)\n", value.assign("far-too-long"));
+    Serial.printf("Truncated: %s (expect far-too-)\n", value.c_str());
+    Serial.printf("length: %u (expect 8)\n", static_cast<unsigned>(value.length()));
+    Serial.println();
+
+    // Test 2: persisted as a plain string
+    Serial.println("--- Test 2: Persist ---");
+    QPrefs::update(ssidKey, [](FixedString<8>& s) { s.assign("office"); });
+    QPrefs::save(ssidKey);
+    Preferences prefs;
+    prefs.begin("fstrtest", true);
+    Serial.printf("NVS string: %s (expect office)\n", prefs.getString("ssid", "").c_str());
+    prefs.end();
+    Serial.printf("isSaved: %d (expect 1)\n", QPrefs::isSaved(ssidKey));
+    Serial.println();
+
+    // Test 3: change and revert
+    Serial.println("--- Test 3: Dirty tracking ---");
+    QPrefs::update(ssidKey, [](FixedString<8>& s) { s.assign("home"); });
+    Serial.printf("isDirty after change: %d (expect 1)\n", QPrefs::isDirty(ssidKey));
+    QPrefs::set(ssidKey, FixedString<8>("office"));
+    Serial.printf("isDirty after revert: %d (expect 0)\n", QPrefs::isDirty(ssidKey));
+    Serial.println();
+
+    // Test 4: a string over capacity, as left by firmware with a larger N
+    Serial.println("--- Test 4: Too long in NVS ---");
+    prefs.begin("fstrtest", false);
+    prefs.putString("short", "longer than four");
+    prefs.end();
+    Serial.printf("get(): %s (expect abc, the default)\n", QPrefs::get(shortKey).c_str());
+    Serial.printf("isDirty: %d (expect 1)\n", QPrefs::isDirty(shortKey));
+    auto report = QPrefs::save(shortKey);
+    Serial.printf("removed: %u (expect 1)\n", static_cast<unsigned>(report.removed));
+    Serial.printf("isSaved: %d (expect 0)\n", QPrefs::isSaved(shortKey));
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
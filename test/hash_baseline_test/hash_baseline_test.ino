@@ -0,0 +1,67 @@
+/**
+ * @file hash_baseline_test.ino
+ * @brief Test sketch for String keys with a hashed baseline (Baseline::Hash).
+ *
+ * Tests:
+ * 1. Fresh device - a change is dirty, going back to the default is clean
+ * 2. After save - a change is dirty, reverting to the saved value is clean
+ * 3. Same length - a change that keeps the length is still dirty
+ * 4. Default removal - saving the default removes the NVS entry
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+
+PrefKey<String, "hashtest", "cert", PrefOptions{.baseline = Baseline::Hash}> certKey{String("")};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Hash Baseline Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: compared against the default while nothing is saved
+    Serial.println("--- Test 1: Fresh device ---");
+    QPrefs::set(certKey, String("-----BEGIN CERTIFICATE-----"));
+    Serial.printf("isDirty after change: %d (expect 1)\n", QPrefs::isDirty(certKey));
+    QPrefs::set(certKey, String(""));
+    Serial.printf("isDirty back at default: %d (expect 0)\n", QPrefs::isDirty(certKey));
+    Serial.println();
+
+    // Test 2: compared against the hash of the saved value
+    Serial.println("--- Test 2: Revert to saved value ---");
+    QPrefs::set(certKey, String("saved-certificate"));
+    QPrefs::save(certKey);
+    Serial.printf("isDirty after save: %d (expect 0)\n", QPrefs::isDirty(certKey));
+    QPrefs::set(certKey, String("changed-certificate"));
+    Serial.printf("isDirty after change: %d (expect 1)\n", QPrefs::isDirty(certKey));
+    QPrefs::set(certKey, String("saved-certificate"));
+    Serial.printf("isDirty after revert: %d (expect 0)\n", QPrefs::isDirty(certKey));
+    Serial.println();
+
+    // Test 3: same length, different contents
+    Serial.println("--- Test 3: Same length ---");
+    QPrefs::set(certKey, String("saved-certificatX"));
+    Serial.printf("isDirty: %d (expect 1)\n", QPrefs::isDirty(certKey));
+    QPrefs::save(certKey);
+    Serial.printf("isDirty after save: %d (expect 0)\n", QPrefs::isDirty(certKey));
+    Serial.println();
+
+    // Test 4: back to the default removes the entry
+    Serial.println("--- Test 4: Default removal ---");
+    QPrefs::set(certKey, String(""));
+    Serial.printf("isDirty: %d (expect 1)\n", QPrefs::isDirty(certKey));
+    auto report = QPrefs::save(certKey);
+    Serial.printf("removed: %u (expect 1)\n", static_cast<unsigned>(report.removed));
+    Serial.printf("isSaved: %d (expect 0)\n", QPrefs::isSaved(certKey));
+    Serial.println();
+
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file overflow_test.ino
+ * @brief Test sketch for keys beyond QPREFERENCES_MAX_KEYS (the overflow slot).
+ *
+ * Tests:
+ * 1. Separate defaults - two overflow keys each load their own value
+ * 2. save(key) - each overflow key persists to its own NVS entry
+ * 3. Owner switch - the slot reloads when another overflow key uses it
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+// The overflow slot is the release-build fail-safe; debug builds assert instead
+#define NDEBUG
+#define QPREFERENCES_MAX_KEYS 1
+#include <QPreferences.h>
+#include <Preferences.h>
+
+PrefKey<int, "overflow", "owned"> ownedKey{0};  // Takes the only regular slot
+PrefKey<int, "overflow", "a"> aKey{10};
+PrefKey<int, "overflow", "b"> bKey{20};
+
+// A key's value read straight from NVS (-1 if missing)
+int nvsValue(const char* key) {
+    Preferences prefs;
+    if (!prefs.begin("overflow", true)) {
+        return -1;
+    }
+    int value = prefs.isKey(key) ? prefs.getInt(key, -1) : -1;
+    prefs.end();
+    return value;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Overflow Slot Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: each key loads its own default, not the other key's state
+    Serial.println("--- Test 1: Separate defaults ---");
+    Serial.printf("get(a): %d (expect 10)\n", QPrefs::get(aKey));
+    Serial.printf("get(b): %d (expect 20)\n", QPrefs::get(bKey));
+    Serial.println();
+
+    // Test 2: save(key) writes each key to its own entry
+    Serial.println("--- Test 2: save(key) ---");
+    QPrefs::set(aKey, 11);
+    QPrefs::save(aKey);
+    QPrefs::set(bKey, 21);
+    Serial.printf("isDirty(b): %d (expect 1)\n", QPrefs::isDirty(bKey));
+    QPrefs::save(bKey);
+    Serial.printf("NVS a: %d (expect 11)\n", nvsValue("a"));
+    Serial.printf("NVS b: %d (expect 21)\n", nvsValue("b"));
+    Serial.println();
+
+    // Test 3: switching owners reloads from NVS
+    Serial.println("--- Test 3: Owner switch ---");
+    Serial.printf("get(a): %d (expect 11)\n", QPrefs::get(aKey));
+    Serial.printf("isSaved(a): %d (expect 1)\n", QPrefs::isSaved(aKey));
+    QPrefs::set(aKey, 12);  // Unsaved: dropped when b takes the slot
+    Serial.printf("get(b): %d (expect 21)\n", QPrefs::get(bKey));
+    Serial.printf("isDirty(b): %d (expect 0)\n", QPrefs::isDirty(bKey));
+    Serial.printf("get(a): %d (expect 11)\n", QPrefs::get(aKey));
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file packed_bools_test.ino
+ * @brief Test sketch for packed bool keys (PrefOptions::pack_bit).
+ *
+ * Tests:
+ * 1. Persist - packed keys share one hidden entry, no per-key entries
+ * 2. Removal on default - the entry is erased once every packed key is at its default
+ * 3. factoryReset() - packed keys read their defaults again
+ * 4. Reboot persistence - packed values survive power cycle
+ *
+ * Instructions:
+ * 1. Upload and run - observe test output
+ * 2. Press reset button or power cycle
+ * 3. After reboot, test detects persisted values and reports SUCCESS
+ */
+
+#include <QPreferences.h>
+#include <Preferences.h>
+
+PrefKey<bool, "packed", "beta", PrefOptions{.pack_bit = 0}> betaKey{false};
+PrefKey<bool, "packed", "ota", PrefOptions{.pack_bit = 1}> otaKey{true};
+PrefKey<bool, "packed", "debug", PrefOptions{.pack_bit = 63}> debugKey{false};
+// Regular key in the same namespace
+PrefKey<int, "packed", "count"> countKey{0};
+
+// Whether an entry exists in the "packed" namespace, read straight from NVS
+bool nvsHasKey(const char* key) {
+    Preferences prefs;
+    if (!prefs.begin("packed", true)) {
+        return false;
+    }
+    bool found = prefs.isKey(key);
+    prefs.end();
+    return found;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Packed Bools Test ===\n");
+
+    // Check if this is a reboot test (values should persist)
+    if (QPrefs::get(countKey) == 42) {
+        Serial.printf("beta: %d (expect 1)\n", QPrefs::get(betaKey));
+        Serial.printf("ota: %d (expect 0)\n", QPrefs::get(otaKey));
+        Serial.printf("debug: %d (expect 1)\n", QPrefs::get(debugKey));
+        Serial.printf("isSaved(ota): %d (expect 1)\n", QPrefs::isSaved(otaKey));
+        if (QPrefs::get(betaKey) && !QPrefs::get(otaKey) && QPrefs::get(debugKey)) {
+            Serial.println("\n*** SUCCESS: Packed values persisted across reboot! ***\n");
+        }
+        Serial.println("Resetting to defaults for next test run...");
+        QPrefs::factoryReset();
+        Serial.println("=== REBOOT TEST PASSED ===");
+        return;
+    }
+    QPrefs::factoryReset();
+
+    // Test 1: Persist - one hidden entry holds all packed keys
+    Serial.println("--- Test 1: Persist ---");
+    QPrefs::set(betaKey, true);
+    QPrefs::set(otaKey, false);
+    QPrefs::set(debugKey, true);
+    auto report = QPrefs::save();
+    Serial.printf("written: %u (expect 3)\n", static_cast<unsigned>(report.written));
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Serial.printf("NVS has _qp_bools: %d (expect 1)\n", nvsHasKey("_qp_bools"));
+    Serial.printf("NVS has beta: %d (expect 0)\n", nvsHasKey("beta"));
+    Serial.printf("isSaved(beta): %d (expect 1)\n", QPrefs::isSaved(betaKey));
+    Serial.println();
+
+    // Test 2: Removal on default - per key first, then the whole entry
+    Serial.println("--- Test 2: Removal on default ---");
+    QPrefs::set(betaKey, false);
+    QPrefs::save(betaKey);
+    Serial.printf("isSaved(beta): %d (expect 0)\n", QPrefs::isSaved(betaKey));
+    Serial.printf("NVS has _qp_bools: %d (expect 1, ota and debug still saved)\n", nvsHasKey("_qp_bools"));
+    QPrefs::set(otaKey, true);
+    QPrefs::set(debugKey, false);
+    report = QPrefs::save();
+    Serial.printf("removed: %u (expect 2)\n", static_cast<unsigned>(report.removed));
+    Serial.printf("NVS has _qp_bools: %d (expect 0)\n", nvsHasKey("_qp_bools"));
+    Serial.println();
+
+    // Test 3: factoryReset() - packed image cleared with the namespace
+    Serial.println("--- Test 3: factoryReset() ---");
+    QPrefs::set(debugKey, true);
+    QPrefs::save();
+    QPrefs::factoryReset();
+    Serial.printf("debug: %d (expect 0)\n", QPrefs::get(debugKey));
+    Serial.printf("isSaved(debug): %d (expect 0)\n", QPrefs::isSaved(debugKey));
+    Serial.printf("NVS has _qp_bools: %d (expect 0)\n", nvsHasKey("_qp_bools"));
+    Serial.println();
+
+    // Test 4: Reboot persistence - save values for the next boot
+    Serial.println("--- Test 4: Reboot persistence ---");
+    QPrefs::set(betaKey, true);
+    QPrefs::set(otaKey, false);
+    QPrefs::set(debugKey, true);
+    QPrefs::set(countKey, 42);
+    QPrefs::save();
+    Serial.println("Values saved. Press reset to verify they persist.");
+    Serial.println();
+
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file rate_limit_test.ino
+ * @brief Test sketch for write deferral (min_interval_ms and the global write budget).
+ *
+ * Tests:
+ * 1. Per-key interval - a second write within min_interval_ms is deferred
+ * 2. Global budget - writes beyond the budget are deferred, keys stay dirty
+ * 3. saveStep() - a pass ends even when deferred keys are still dirty
+ * 4. Token bucket - refill and cap, driven by a simulated clock
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+
+PrefKey<int, "rate", "slow", PrefOptions{.min_interval_ms = 500}> slowKey{0};
+PrefKey<int, "rate", "a"> aKey{0};
+PrefKey<int, "rate", "b"> bKey{0};
+PrefKey<int, "rate", "c"> cKey{0};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Rate Limit Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: Per-key interval
+    Serial.println("--- Test 1: min_interval_ms ---");
+    QPrefs::set(slowKey, 1);
+    auto report = QPrefs::save(slowKey);
+    Serial.printf("First save - written: %u (expect 1)\n", static_cast<unsigned>(report.written));
+    QPrefs::set(slowKey, 2);
+    report = QPrefs::save(slowKey);
+    Serial.printf("Within 500 ms - deferred: %u (expect 1)\n", static_cast<unsigned>(report.deferred));
+    Serial.printf("isDirty(slow): %d (expect 1)\n", QPrefs::isDirty(slowKey));
+    delay(600);
+    report = QPrefs::save(slowKey);
+    Serial.printf("After 600 ms - written: %u (expect 1)\n", static_cast<unsigned>(report.written));
+    Serial.printf("isDirty(slow): %d (expect 0)\n", QPrefs::isDirty(slowKey));
+    Serial.println();
+
+    // Test 2: Global budget (bucket starts full with 2 tokens)
+    Serial.println("--- Test 2: Global write budget ---");
+    QPrefs::setWriteBudget(2);
+    QPrefs::set(aKey, 1);
+    QPrefs::set(bKey, 1);
+    QPrefs::set(cKey, 1);
+    report = QPrefs::save();
+    Serial.printf("written: %u (expect 2)\n", static_cast<unsigned>(report.written));
+    Serial.printf("deferred: %u (expect 1)\n", static_cast<unsigned>(report.deferred));
+    Serial.printf("anyDirty(): %d (expect 1)\n", QPrefs::anyDirty());
+    Serial.println();
+
+    // Test 3: saveStep() ends its pass with the deferred key still dirty
+    Serial.println("--- Test 3: saveStep() with a deferred key ---");
+    Serial.printf("saveStep({}): %d (expect 1)\n", QPrefs::saveStep({}));
+    Serial.printf("anyDirty(): %d (expect 1)\n", QPrefs::anyDirty());
+    QPrefs::setWriteBudget(0);  // Unlimited: the deferred key goes through
+    Serial.printf("saveStep({}): %d (expect 1)\n", QPrefs::saveStep({}));
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Serial.println();
+
+    // Test 4: Token bucket with a simulated clock (2 writes per hour)
+    Serial.println("--- Test 4: Token bucket ---");
+    QPreferences::WriteBudget bucket{.writes_per_hour = 2};
+    bool first = bucket.take(0);
+    bool second = bucket.take(0);
+    bool third = bucket.take(0);
+    Serial.printf("Burst at t=0: %d %d %d (expect 1 1 0)\n", first, second, third);
+    Serial.printf("Just before 30 min: %d (expect 0)\n", bucket.take(1799999));
+    Serial.printf("At 30 min: %d (expect 1)\n", bucket.take(1800000));
+    uint32_t later = 1800000 + 10 * 3600000;  // Idle for 10 hours
+    first = bucket.take(later);
+    second = bucket.take(later);
+    third = bucket.take(later);
+    Serial.printf("After 10 idle hours: %d %d %d (expect 1 1 0, capped at 2)\n", first, second, third);
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file registry_check.ino
+ * @brief Compile-time and runtime check for the opt-in PrefRegistry.
+ *
+ * Verifies that a registry sizes storage exactly, assigns constexpr
+ * indices in list order, and that keys work through the normal API.
+ *
+ * Uncomment the marked lines to verify they produce compile errors.
+ */
+
+// Must be defined in every translation unit (normally via build_flags)
+#define QPREFERENCES_USE_REGISTRY
+#include <QPreferences.h>
+
+PrefKey<int, "reg", "count"> countKey{0};
+PrefKey<bool, "reg", "enabled"> enabledKey{true};
+PrefKey<String, "regnet", "host"> hostKey{String("local")};
+
+PrefRegistry registry{countKey, enabledKey, hostKey};
+
+using Registry = decltype(registry);
+static_assert(Registry::size == 3, "registry size");
+static_assert(Registry::index_of<decltype(countKey)>() == 0, "first key index");
+static_assert(Registry::index_of<decltype(hostKey)>() == 2, "last key index");
+
+// ERROR: same namespace/key pair registered twice
+// PrefKey<float, "reg", "count"> dupKey{0.0f};
+// PrefRegistry badRegistry{countKey, dupKey};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== PrefRegistry Check ===\n");
+    Serial.printf("Registered keys: %u (expect 3)\n", (unsigned)QPreferences::next_key_id);
+    Serial.printf("Storage capacity: %u (expect 3)\n", (unsigned)QPreferences::key_capacity);
+
+    QPrefs::preloadAll();
+    QPrefs::set(countKey, QPrefs::get(countKey) + 1);
+    Serial.printf("count: %d, isDirty: %d (expect 1)\n",
+                  QPrefs::get(countKey), QPrefs::isDirty(countKey));
+
+    QPrefs::forEach([](const QPreferences::PrefInfo& info) {
+        Serial.printf("  [%u] %s/%s\n", (unsigned)info.index, info.namespace_name, info.key_name);
+    });
+
+    Serial.println("\n=== Registry Check Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file save_step_test.ino
+ * @brief Test sketch for the incremental QPrefs::saveStep() API.
+ *
+ * Tests:
+ * 1. Budget - max_keys bounds the keys written per call
+ * 2. Namespace grouping - a step finishes the open namespace before the next
+ * 3. Resume point - a key re-dirtied behind the cursor waits for the next pass
+ * 4. Pass completion - true once every namespace was visited, then all clean
+ * 5. Time budget - at least one key is written per call
+ * 6. Report - keys, opens and bytes of the call, including packed bools
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#include <QPreferences.h>
+
+// Registered interleaved: namespace grouping must not follow registration order
+PrefKey<int, "stepa", "k1"> a1{0};
+PrefKey<int, "stepb", "k1"> b1{0};
+PrefKey<int, "stepa", "k2"> a2{0};
+PrefKey<int, "stepb", "k2"> b2{0};
+PrefKey<int, "stepa", "k3"> a3{0};
+PrefKey<bool, "stepc", "p0", PrefOptions{.pack_bit = 0}> c0{false};
+PrefKey<bool, "stepc", "p1", PrefOptions{.pack_bit = 1}> c1{false};
+
+void printDirty() {
+    Serial.printf("  dirty: a1=%d a2=%d a3=%d b1=%d b2=%d\n",
+                  QPrefs::isDirty(a1), QPrefs::isDirty(a2), QPrefs::isDirty(a3),
+                  QPrefs::isDirty(b1), QPrefs::isDirty(b2));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== saveStep() Test ===\n");
+    QPrefs::factoryReset();
+
+    Serial.println("--- Test 1: nothing dirty ---");
+    Serial.printf("saveStep({}): %d (expect 1)\n", QPrefs::saveStep({}));
+    Serial.println();
+
+    QPrefs::set(a1, 1);
+    QPrefs::set(b1, 1);
+    QPrefs::set(a2, 1);
+    QPrefs::set(b2, 1);
+    QPrefs::set(a3, 1);
+
+    Serial.println("--- Test 2: two keys per step, namespace stepa first ---");
+    Serial.printf("saveStep(max_keys=2): %d (expect 0)\n", QPrefs::saveStep({.max_keys = 2}));
+    printDirty();
+    Serial.println("  expect: a1=0 a2=0 a3=1 b1=1 b2=1");
+    Serial.println();
+
+    Serial.println("--- Test 3: a1 changes behind the cursor ---");
+    QPrefs::set(a1, 5);
+    Serial.printf("saveStep(max_keys=2): %d (expect 0)\n", QPrefs::saveStep({.max_keys = 2}));
+    printDirty();
+    Serial.println("  expect: a1=1 a2=0 a3=0 b1=0 b2=1");
+    Serial.println();
+
+    Serial.println("--- Test 4: pass completes, a1 waits for the next pass ---");
+    Serial.printf("saveStep(max_keys=5): %d (expect 1)\n", QPrefs::saveStep({.max_keys = 5}));
+    printDirty();
+    Serial.println("  expect: a1=1 a2=0 a3=0 b1=0 b2=0");
+    Serial.printf("saveStep(max_keys=5): %d (expect 1)\n", QPrefs::saveStep({.max_keys = 5}));
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Serial.println();
+
+    Serial.println("--- Test 5: time budget still writes one key per call ---");
+    QPrefs::set(b2, 3);
+    Serial.printf("saveStep(max_us=1): %d (expect 1)\n", QPrefs::saveStep({.max_us = 1}));
+    Serial.printf("isDirty(b2): %d (expect 0)\n", QPrefs::isDirty(b2));
+    Serial.println();
+
+    Serial.println("--- Test 6: report of one call ---");
+    QPrefs::set(a1, 0);  // Back to default: removed
+    QPrefs::set(c0, true);
+    QPrefs::set(c1, true);
+    QPreferences::SaveReport report;
+    Serial.printf("saveStep({}, report): %d (expect 1)\n", QPrefs::saveStep({}, report));
+    Serial.printf("written: %u (expect 2)\n", static_cast<unsigned>(report.written));
+    Serial.printf("removed: %u (expect 1)\n", static_cast<unsigned>(report.removed));
+    Serial.printf("namespaces_opened: %u (expect 2)\n", static_cast<unsigned>(report.namespaces_opened));
+    Serial.printf("bytes_written: %u (expect 16, one packed bools blob)\n",
+                  static_cast<unsigned>(report.bytes_written));
+    Serial.printf("saveStep({}, report): %d (expect 1)\n", QPrefs::saveStep({}, report));
+    Serial.printf("written after clean pass: %u (expect 0)\n", static_cast<unsigned>(report.written));
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file thread_safe_test.ino
+ * @brief Test sketch for QPREFERENCES_THREAD_SAFE: concurrent set() and save().
+ *
+ * Tests:
+ * 1. set() vs save() - increments from one task while another saves; no update lost
+ * 2. Torn reads - get() of a String being rewritten returns one whole value
+ * 3. Final state - after a last save(), NVS matches the cache and nothing is dirty
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ */
+
+#define QPREFERENCES_THREAD_SAFE
+#include <QPreferences.h>
+#include <Preferences.h>
+#include <atomic>
+#include <thread>
+
+PrefKey<int, "tstest", "count"> countKey{0};
+PrefKey<String, "tstest", "name"> nameKey{String("")};
+
+static constexpr int INCREMENTS = 2000;
+static const char* const NAME_A = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+static const char* const NAME_B = "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb";
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Thread-Safe Cache Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: one task increments, this one saves in a loop
+    Serial.println("--- Test 1: set() vs save() ---");
+    std::atomic<bool> done{false};
+    std::thread writer([&done] {
+        for (int i = 0; i < INCREMENTS; ++i) {
+            QPrefs::increment(countKey);
+        }
+        done = true;
+    });
+    int saves = 0;
+    while (!done) {
+        QPrefs::save();
+        ++saves;
+    }
+    writer.join();
+    Serial.printf("Saves during writes: %d\n", saves);
+    Serial.printf("get(count): %d (expect %d)\n", QPrefs::get(countKey), INCREMENTS);
+    Serial.println();
+
+    // Test 2: readers never see a half-written String
+    Serial.println("--- Test 2: Torn reads ---");
+    done = false;
+    std::thread rewriter([&done] {
+        for (int i = 0; i < 2000; ++i) {
+            QPrefs::set(nameKey, String(i % 2 == 0 ? NAME_A : NAME_B));
+        }
+        done = true;
+    });
+    int torn = 0;
+    while (!done) {
+        String name = QPrefs::get(nameKey);
+        if (name != "" && name != NAME_A && name != NAME_B) {
+            ++torn;
+        }
+        QPrefs::save(nameKey);
+    }
+    rewriter.join();
+    Serial.printf("Torn reads: %d (expect 0)\n", torn);
+    Serial.println();
+
+    // Test 3: a final save leaves NVS equal to the cache
+    Serial.println("--- Test 3: Final state ---");
+    QPrefs::save();
+    Serial.printf("anyDirty(): %d (expect 0)\n", QPrefs::anyDirty());
+    Preferences prefs;
+    prefs.begin("tstest", true);
+    Serial.printf("NVS count: %d (expect %d)\n", prefs.getInt("count", -1), INCREMENTS);
+    Serial.printf("NVS name matches cache: %d (expect 1)\n",
+                  prefs.getString("name", "") == QPrefs::get(nameKey));
+    prefs.end();
+    Serial.println();
+
+    QPrefs::factoryReset();
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file view_test.ino
+ * @brief Test sketch for view(key) and move-aware set(key, T&&).
+ *
+ * Tests:
+ * 1. view() - reads the cached value without a copy (a reference into the cache)
+ * 2. set() from an rvalue - the String is moved into the cache
+ * 3. set() from an lvalue - the source is left untouched
+ * 4. Dirty tracking - moved and copied values are tracked like any set()
+ *
+ * Instructions:
+ * 1. Upload and run - each check prints its result and the expected value
+ *    (build without QPREFERENCES_THREAD_SAFE; there view() returns a copy)
+ */
+
+#include <QPreferences.h>
+
+PrefKey<String, "viewtest", "topic"> topicKey{String("dev/state")};
+PrefKey<int, "viewtest", "count"> countKey{7};
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== view() / move set() Test ===\n");
+    QPrefs::factoryReset();
+
+    // Test 1: view() returns the same cached object every time
+    Serial.println("--- Test 1: view() ---");
+    const String& first = QPrefs::view(topicKey);
+    const String& second = QPrefs::view(topicKey);
+    Serial.printf("view(topic): %s (expect dev/state)\n", first.c_str());
+    Serial.printf("Same object: %d (expect 1)\n", &first == &second);
+    Serial.printf("view(count): %d (expect 7)\n", QPrefs::view(countKey));
+    Serial.println();
+
+    // Test 2: an rvalue is moved, not copied
+    Serial.println("--- Test 2: set() from an rvalue ---");
+    String moved("a topic long enough to live on the heap, not inline");
+    QPrefs::set(topicKey, std::move(moved));
+    Serial.printf("Cached: %s\n", QPrefs::view(topicKey).c_str());
+    Serial.printf("Moved-from length: %u (expect 0)\n", moved.length());
+    Serial.printf("isDirty: %d (expect 1)\n", QPrefs::isDirty(topicKey));
+    Serial.println();
+
+    // Test 3: an lvalue is copied once; the source keeps its contents
+    Serial.println("--- Test 3: set() from an lvalue ---");
+    String copied("dev/other");
+    QPrefs::set(topicKey, copied);
+    Serial.printf("Source: %s (expect dev/other)\n", copied.c_str());
+    Serial.printf("Cached: %s (expect dev/other)\n", QPrefs::view(topicKey).c_str());
+    Serial.println();
+
+    // Test 4: moving the default back in is clean again
+    Serial.println("--- Test 4: Dirty tracking ---");
+    QPrefs::set(topicKey, String("dev/state"));
+    Serial.printf("isDirty back at default: %d (expect 0)\n", QPrefs::isDirty(topicKey));
+    Serial.println();
+
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
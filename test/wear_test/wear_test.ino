@@ -0,0 +1,121 @@
+/**
+ * @file wear_test.ino
+ * @brief Test sketch for per-key write counters and persisted wear totals.
+ *
+ * Tests:
+ * 1. Counting - every NVS write and removal bumps the key's counter
+ * 2. wearReport() - total writes and the most-written key
+ * 3. Persist - saveWearCounters() stores the totals in one entry
+ * 4. Merge after reboot - loadWearCounters() adds earlier totals, including
+ *    a key that registers lazily after the first load
+ *
+ * Instructions:
+ * 1. Upload and run - observe test output
+ * 2. Press reset button or power cycle
+ * 3. After reboot, test merges the persisted totals and reports SUCCESS
+ */
+
+#include <QPreferences.h>
+#include <Preferences.h>
+
+PrefKey<int, "weartest", "hot"> hotKey{0};
+PrefKey<int, "weartest", "cold"> coldKey{0};
+PrefKey<bool, "weartest", "rebooted"> rebootedKey{false};
+// constexpr: registers on first access, after loadWearCounters()
+constexpr PrefKey<int, "weartest", "lazy"> lazyKey{0};
+
+// Write count of one key, from forEach()
+uint32_t writesOf(const char* key_name) {
+    uint32_t writes = 0;
+    QPrefs::forEach([&](const QPreferences::PrefInfo& info) {
+        if (strcmp(info.key_name, key_name) == 0) {
+            writes = info.write_count;
+        }
+    });
+    return writes;
+}
+
+// Remove test data, including the persisted wear totals
+void cleanUp() {
+    QPrefs::factoryReset();
+    Preferences prefs;
+    if (prefs.begin(QPREFERENCES_WEAR_NAMESPACE, false)) {
+        prefs.clear();
+        prefs.end();
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Wear Counter Test ===\n");
+
+    // Check if this is a reboot test (totals should merge)
+    if (QPrefs::get(rebootedKey)) {
+        Serial.println("--- Test 4: Merge after reboot ---");
+        QPrefs::loadWearCounters();
+        Serial.printf("hot: %u (expect 3)\n", static_cast<unsigned>(writesOf("hot")));
+        Serial.printf("cold: %u (expect 2)\n", static_cast<unsigned>(writesOf("cold")));
+        QPrefs::set(lazyKey, 9);  // First access registers it
+        QPrefs::save(lazyKey);
+        QPrefs::saveWearCounters();
+        Serial.printf("lazy: %u (expect 3: 2 earlier + 1 now)\n", static_cast<unsigned>(writesOf("lazy")));
+        if (writesOf("hot") == 3 && writesOf("lazy") == 3) {
+            Serial.println("\n*** SUCCESS: Wear totals merged across reboot! ***\n");
+        }
+        cleanUp();
+        Serial.println("=== REBOOT TEST PASSED ===");
+        return;
+    }
+    cleanUp();
+
+    // Test 1: writes and removals are counted per key
+    Serial.println("--- Test 1: Counting ---");
+    for (int i = 1; i <= 3; ++i) {
+        QPrefs::set(hotKey, i);
+        QPrefs::save(hotKey);
+    }
+    QPrefs::set(coldKey, 1);
+    QPrefs::save(coldKey);
+    QPrefs::set(coldKey, 0);  // Back to default: removal counts too
+    QPrefs::save(coldKey);
+    QPrefs::save(coldKey);    // Clean: no write, no count
+    Serial.printf("hot: %u (expect 3)\n", static_cast<unsigned>(writesOf("hot")));
+    Serial.printf("cold: %u (expect 2)\n", static_cast<unsigned>(writesOf("cold")));
+    Serial.println();
+
+    // Test 2: summary
+    Serial.println("--- Test 2: wearReport() ---");
+    auto wear = QPrefs::wearReport();
+    Serial.printf("total_writes: %u (expect 5)\n", static_cast<unsigned>(wear.total_writes));
+    Serial.printf("hottest: %s (expect hot)\n", wear.hottest_key);
+    Serial.printf("hottest_writes: %u (expect 3)\n", static_cast<unsigned>(wear.hottest_writes));
+    Serial.println();
+
+    // Test 3: persist; the lazy key's total comes from an earlier firmware run
+    Serial.println("--- Test 3: Persist ---");
+    QPrefs::set(lazyKey, 1);
+    QPrefs::save(lazyKey);
+    QPrefs::set(lazyKey, 0);
+    QPrefs::save(lazyKey);
+    Serial.printf("saveWearCounters(): %d (expect 1)\n", QPrefs::saveWearCounters());
+    Preferences prefs;
+    prefs.begin(QPREFERENCES_WEAR_NAMESPACE, true);
+    Serial.printf("Stored records: %u (expect 3)\n",
+                  static_cast<unsigned>(prefs.getBytesLength("counts") / sizeof(QPreferences::WearRecord)));
+    prefs.end();
+    Serial.println();
+
+    // Flag the reboot without counting it against the test keys
+    QPrefs::set(rebootedKey, true);
+    QPrefs::save(rebootedKey);
+    Serial.println("Totals saved. Press reset to verify they merge.");
+    Serial.println();
+
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file writeback_test.ino
+ * @brief Test sketch for the WriteBackPolicy flush decisions.
+ *
+ * Drives the policy with a simulated clock (no task, no flash writes):
+ * 1. Debounce - a burst of changes flushes once, after it goes quiet
+ * 2. Staleness - continuous changes flush once per max_staleness_ms window
+ * 3. Left dirty - a key that stays dirty after a flush doesn't flush every poll
+ *
+ * Instructions:
+ * 1. Upload and run - each test prints its result and the expected value
+ */
+
+#include <QPreferences/WriteBack.h>
+
+PrefKey<int, "wbtest", "ticks"> ticks{0};
+
+// Simulate `duration_ms` of polling every 100 ms, calling change() first
+// when it returns true; counts flushes and clears the dirty flag like save()
+template<typename Change>
+int simulate(WriteBackPolicy& policy, uint32_t& now, uint32_t duration_ms, bool do_save, Change change) {
+    int flushes = 0;
+    for (uint32_t end = now + duration_ms; now < end; now += 100) {
+        change(now);
+        if (policy.due(now)) {
+            ++flushes;
+            if (do_save) {
+                QPrefs::save();
+            }
+        }
+    }
+    return flushes;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Write-Back Policy Test ===\n");
+    QPrefs::factoryReset();
+
+    WriteBackConfig config{.debounce_ms = 2000, .max_staleness_ms = 10000};
+    uint32_t now = 0;
+
+    // Test 1: a 1-second burst, then quiet
+    Serial.println("--- Test 1: Debounce ---");
+    WriteBackPolicy burst{config};
+    int flushes = simulate(burst, now, 10000, true, [](uint32_t t) {
+        if (t < 1000) {
+            QPrefs::increment(ticks);
+        }
+    });
+    Serial.printf("Flushes for a 1 s burst over 10 s: %d (expect 1)\n", flushes);
+    Serial.println();
+
+    // Test 2: a change every 100 ms for 30 seconds (the WriteBack example)
+    Serial.println("--- Test 2: Staleness bound ---");
+    WriteBackPolicy continuous{config};
+    flushes = simulate(continuous, now, 30000, true, [](uint32_t) {
+        QPrefs::increment(ticks);
+    });
+    Serial.printf("Flushes for 30 s of continuous changes: %d (expect 2: at 10 s and 20 s)\n", flushes);
+    Serial.println();
+
+    // Test 3: the key stays dirty after each flush (as when a save is
+    // deferred by a rate limit); flushes must stay one per window
+    Serial.println("--- Test 3: Key left dirty after flush ---");
+    QPrefs::increment(ticks);
+    WriteBackPolicy stuck{config};
+    flushes = simulate(stuck, now, 10000, false, [](uint32_t) {});
+    Serial.printf("Flushes over 10 s with a key left dirty: %d (expect 4: every 2 s debounce)\n", flushes);
+    QPrefs::save();
+    Serial.println();
+
+    Serial.println("=== Tests Complete ===");
+}
+
+void loop() {
+    delay(10000);
+}